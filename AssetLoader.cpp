@@ -0,0 +1,107 @@
+#include "AssetLoader.h"
+#include "MeshCache.h"
+#include "MeshSimplify.h"
+#include "Texture.h"
+#include "Trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+void UploadQueue::push(std::function<void()> upload)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back(std::move(upload));
+}
+
+int UploadQueue::drain()
+{
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.swap(pending);
+    }
+    for (auto& upload : ready) upload();
+    return static_cast<int>(ready.size());
+}
+
+AssetLoader::AssetLoader(JobSystem& jobs)
+    : jobs(jobs)
+{
+}
+
+void AssetLoader::loadTexture(const char* path, unsigned int& texture)
+{
+    std::string file = path;
+    jobs.submit([this, file, &texture] {
+        TraceScope trace("loadTexture", "assets", file.c_str());
+        auto image = std::make_shared<ImageData>();
+        decodeImage(file.c_str(), true, *image);
+        uploads.push([file, image, &texture] {
+            TraceScope trace("uploadTexture", "assets", file.c_str());
+            texture = uploadTexture(*image);
+        });
+    }, &pending);
+}
+
+void AssetLoader::loadCubemap(const std::vector<std::string>& faces, unsigned int& texture)
+{
+    // kazda sciana osobno; ostatnia zdekodowana zleca utworzenie cubemapy
+    struct CubemapJob
+    {
+        std::vector<ImageData> images;
+        std::atomic<int> remaining;
+    };
+    auto job = std::make_shared<CubemapJob>();
+    job->images.resize(faces.size());
+    job->remaining = static_cast<int>(faces.size());
+
+    for (size_t i = 0; i < faces.size(); ++i) {
+        std::string file = faces[i];
+        jobs.submit([this, job, i, file, &texture] {
+            TraceScope trace("loadCubemap", "assets", file.c_str());
+            decodeImage(file.c_str(), false, job->images[i]);
+            if (job->remaining.fetch_sub(1) == 1)
+                uploads.push([job, &texture] { texture = uploadCubemap(job->images); });
+        }, &pending);
+    }
+}
+
+void AssetLoader::loadObj(const char* path, Mesh& mesh)
+{
+    std::string file = path;
+    jobs.submit([this, file, &mesh] {
+        TraceScope trace("loadObj", "assets", file.c_str());
+        auto start = std::chrono::steady_clock::now();
+
+        auto cache = std::make_shared<MeshCacheView>();
+        if (openMeshCache(file.c_str(), *cache)) {
+            uploads.push([file, cache, start, &mesh] {
+                TraceScope trace("uploadMesh", "assets", file.c_str());
+                uploadMeshCache(*cache, mesh);
+                logMeshLoad(file.c_str(), mesh, nullptr, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            });
+            return;
+        }
+
+        auto data = std::make_shared<MeshData>();
+        if (!parseObj(file.c_str(), *data)) return;
+        generateMeshLods(*data);
+        storeMeshCache(file.c_str(), *data);
+        uploads.push([file, data, start, &mesh] {
+            TraceScope trace("uploadMesh", "assets", file.c_str());
+            uploadMesh(*data, mesh);
+            logMeshLoad(file.c_str(), mesh, data.get(), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        });
+    }, &pending);
+}
+
+void AssetLoader::finish()
+{
+    while (!pending.done()) {
+        // watek glowny tez dekoduje, gdy nie ma nic do wyslania
+        if (uploads.drain() == 0 && !jobs.runOne())
+            std::this_thread::yield();
+    }
+    uploads.drain();
+}
@@ -0,0 +1,47 @@
+#pragma once
+#ifndef ASSET_LOADER_CLASS_H
+#define ASSET_LOADER_CLASS_H
+
+#include "JobSystem.h"
+#include "Mesh.h"
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Kolejka operacji GL zlecanych z watkow roboczych, wykonywana na watku glownym.
+class UploadQueue
+{
+public:
+    void push(std::function<void()> upload);
+    // wykonuje wszystko, co czeka; zwraca liczbe wykonanych operacji
+    int drain();
+
+private:
+    std::mutex mutex;
+    std::vector<std::function<void()>> pending;
+};
+
+// Rownolegle ladowanie zasobow: dekodowanie obrazow i parsowanie OBJ na puli
+// watkow, tworzenie tekstur/VAO na watku glownym w finish(). Wyniki trafiaja
+// do zmiennych przekazanych przez referencje - musza zyc do konca finish().
+class AssetLoader
+{
+public:
+    explicit AssetLoader(JobSystem& jobs);
+
+    void loadTexture(const char* path, unsigned int& texture);
+    void loadCubemap(const std::vector<std::string>& faces, unsigned int& texture);
+    void loadObj(const char* path, Mesh& mesh);
+
+    // watek glowny: wysyla gotowe zasoby do GL, az wszystkie zadania sie skoncza
+    void finish();
+
+private:
+    JobSystem& jobs;
+    UploadQueue uploads;
+    JobCounter pending;
+};
+
+#endif
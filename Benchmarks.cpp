@@ -0,0 +1,310 @@
+#include "Benchmarks.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "FishSystem.h"
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "Mesh.h"
+#include "MeshSimplify.h"
+#include "Random.h"
+#include "SphereBVH.h"
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static double elapsedNs(BenchClock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+}
+
+int runBoidsBenchmark(int fishCount)
+{
+    const int FRAMES = 60;
+    const int SCHOOL_SIZE = 32;
+    const float dt = 1.0f / 60.0f;
+
+    //lawice rozrzucone po obszarze skalowanym z liczba ryb (stala gestosc)
+    Random random(1234);
+    FishBounds bounds;
+    bounds.despawnZ = -1e9f;   //bez respawnu - mierzymy tylko lawice
+    FishSystem fish(bounds);
+    fish.addSpecies(0.5f);
+    float area = std::sqrt((float)fishCount) * 2.0f;
+    for (int i = 0; i < fishCount; i += SCHOOL_SIZE) {
+        float r[6];
+        random.fillFloats(r, 6);
+        glm::vec3 center((r[0] - 0.5f) * area, -9.0f + r[1] * 6.0f, (r[2] - 0.5f) * area);
+        glm::vec3 dir = glm::normalize(glm::vec3(r[3] - 0.5f, (r[4] - 0.5f) * 0.2f, r[5] - 0.5f));
+        for (int k = 0; k < SCHOOL_SIZE && i + k < fishCount; ++k) {
+            random.fillFloats(r, 3);
+            glm::vec3 offset((r[0] - 0.5f) * 6.0f, (r[1] - 0.5f) * 2.0f, (r[2] - 0.5f) * 6.0f);
+            fish.add(center + offset, dir, std::atan2(dir.x, dir.z));
+        }
+    }
+
+    const BoidParams& params = fish.boidParams();
+    double gridNs = 0.0, queryNs = 0.0, steerNs = 0.0;
+    long long neighbourTotal = 0;
+
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        //budowa siatki (haszowanie + sortowanie przez zliczanie)
+        SpatialGrid grid;
+        BenchClock::time_point start = BenchClock::now();
+        grid.build(fish.x.data(), fish.y.data(), fish.z.data(), 0, fish.size(), params.neighbourRadius);
+        gridNs += elapsedNs(start);
+
+        //samo zapytanie o sasiadow: liczba ryb w promieniu
+        start = BenchClock::now();
+        float radius2 = params.neighbourRadius * params.neighbourRadius;
+        SpatialGrid::SlotRange ranges[27];
+        for (int slot = 0; slot < grid.pointCount(); ++slot) {
+            float px = grid.sortedX[slot], py = grid.sortedY[slot], pz = grid.sortedZ[slot];
+            int n = grid.neighbourRanges(grid.cellCoord(px), grid.cellCoord(py), grid.cellCoord(pz), ranges);
+            for (int r = 0; r < n; ++r) {
+                for (int j = ranges[r].begin; j < ranges[r].end; ++j) {
+                    float dx = px - grid.sortedX[j], dy = py - grid.sortedY[j], dz = pz - grid.sortedZ[j];
+                    if (dx * dx + dy * dy + dz * dz < radius2) neighbourTotal++;
+                }
+            }
+        }
+        queryNs += elapsedNs(start);
+
+        //pelny krok: siatka + sterowanie + calkowanie
+        start = BenchClock::now();
+        fish.steer(dt);
+        fish.update(0.1f, 0.0f);
+        steerNs += elapsedNs(start);
+    }
+
+    double perFish = 1.0 / ((double)FRAMES * fish.size());
+    std::cout << "INFO: Boids: " << fish.size() << " ryb, " << FRAMES << " klatek, kernel " << FishSystem::kernelName() << std::endl;
+    std::cout << "  budowa siatki:      " << gridNs * perFish << " ns/ryba" << std::endl;
+    std::cout << "  zapytanie sasiadow: " << queryNs * perFish << " ns/ryba (srednio "
+              << (double)neighbourTotal * perFish << " sasiadow)" << std::endl;
+    std::cout << "  krok lawicy:        " << steerNs * perFish << " ns/ryba ("
+              << steerNs / FRAMES / 1e6 << " ms/klatke)" << std::endl;
+    return 0;
+}
+
+int runJobsBenchmark()
+{
+    const int JOBS = 200000;
+    const int ROUNDS = 5;
+    JobSystem jobs;
+    std::atomic<int> sink{ 0 };
+
+    double submitNs = 0.0, nestedNs = 0.0, forNs = 0.0, chainNs = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        //puste zadania zlecane z watku glownego
+        JobCounter counter;
+        BenchClock::time_point start = BenchClock::now();
+        for (int i = 0; i < JOBS; ++i)
+            jobs.submit([&sink] { sink.fetch_add(1, std::memory_order_relaxed); }, &counter);
+        jobs.wait(counter);
+        submitNs += elapsedNs(start);
+
+        //zadania zlecane z watkow roboczych (kradziez z ich kolejek)
+        const int PRODUCERS = 64;
+        start = BenchClock::now();
+        for (int p = 0; p < PRODUCERS; ++p) {
+            jobs.submit([&jobs, &sink, &counter] {
+                for (int i = 0; i < JOBS / PRODUCERS; ++i)
+                    jobs.submit([&sink] { sink.fetch_add(1, std::memory_order_relaxed); }, &counter);
+            }, &counter);
+        }
+        jobs.wait(counter);
+        nestedNs += elapsedNs(start);
+
+        //parallelFor z paczka 1 - koszt na paczke
+        start = BenchClock::now();
+        jobs.parallelFor(0, JOBS, 1, [&sink](int b, int e) { sink.fetch_add(e - b, std::memory_order_relaxed); });
+        forNs += elapsedNs(start);
+
+        //lancuch zaleznosci: kazde zadanie czeka na poprzednie
+        const int CHAIN = 10000;
+        std::vector<JobCounter> links(CHAIN);
+        start = BenchClock::now();
+        jobs.submit([&sink] { sink.fetch_add(1, std::memory_order_relaxed); }, &links[0]);
+        for (int i = 1; i < CHAIN; ++i)
+            jobs.submitAfter(links[i - 1], [&sink] { sink.fetch_add(1, std::memory_order_relaxed); }, &links[i]);
+        jobs.wait(links[CHAIN - 1]);
+        chainNs += elapsedNs(start) * ((double)JOBS / CHAIN);
+    }
+
+    double perJob = 1.0 / ((double)ROUNDS * JOBS);
+    std::cout << "INFO: Zadania: " << jobs.workerCount() + 1 << " watkow, " << JOBS << " zadan x " << ROUNDS << std::endl;
+    std::cout << "  submit z watku glownego: " << submitNs * perJob << " ns/zadanie" << std::endl;
+    std::cout << "  submit z watkow roboczych: " << nestedNs * perJob << " ns/zadanie" << std::endl;
+    std::cout << "  parallelFor (paczka 1): " << forNs * perJob << " ns/paczke" << std::endl;
+    std::cout << "  lancuch zaleznosci: " << chainNs * perJob << " ns/zadanie" << std::endl;
+    return sink.load() > 0 ? 0 : 1;
+}
+
+int runRandomBenchmark()
+{
+    const int COUNT = 1 << 16;
+    const int ROUNDS = 200;
+    std::vector<float> out(COUNT);
+    double sum = 0.0;
+
+    srand(1);
+    BenchClock::time_point start = BenchClock::now();
+    for (int round = 0; round < ROUNDS; ++round)
+        for (int i = 0; i < COUNT; ++i)
+            out[i] = rand() / (float)RAND_MAX;
+    double randNs = elapsedNs(start);
+    sum += out[COUNT - 1];
+
+    Random random(1);
+    start = BenchClock::now();
+    for (int round = 0; round < ROUNDS; ++round)
+        for (int i = 0; i < COUNT; ++i)
+            out[i] = random.nextFloat();
+    double nextNs = elapsedNs(start);
+    sum += out[COUNT - 1];
+
+    start = BenchClock::now();
+    for (int round = 0; round < ROUNDS; ++round)
+        random.fillFloats(out.data(), COUNT);
+    double fillNs = elapsedNs(start);
+    sum += out[COUNT - 1];
+
+    RandomBatch batch(random);
+    start = BenchClock::now();
+    for (int round = 0; round < ROUNDS; ++round)
+        batch.fillFloats(out.data(), COUNT);
+    double batchNs = elapsedNs(start);
+    sum += out[COUNT - 1];
+
+    double perFloat = 1.0 / ((double)ROUNDS * COUNT);
+    std::cout << "INFO: Liczby losowe: " << ROUNDS << " x " << COUNT << " floatow (suma kontrolna " << sum << ")" << std::endl;
+    std::cout << "  rand():                  " << randNs * perFloat << " ns/float" << std::endl;
+    std::cout << "  Random::nextFloat:       " << nextNs * perFloat << " ns/float" << std::endl;
+    std::cout << "  Random::fillFloats:      " << fillNs * perFloat << " ns/float" << std::endl;
+    std::cout << "  RandomBatch::fillFloats: " << batchNs * perFloat << " ns/float" << std::endl;
+    return 0;
+}
+
+int runCullBenchmark(int plantCount)
+{
+    const int FRAMES = 120;
+
+    //rosliny na dnie z gestoscia jak w scenie (400 na 300x300 na typ)
+    Random random(99);
+    float side = 300.0f * std::sqrt(plantCount / 1600.0f);
+    std::vector<float> x(plantCount), y(plantCount), z(plantCount), r(plantCount);
+    for (int i = 0; i < plantCount; ++i) {
+        x[i] = (random.nextFloat() - 0.5f) * side;
+        y[i] = -10.0f;
+        z[i] = (random.nextFloat() - 0.5f) * side;
+        r[i] = random.range(0.5f, 2.0f);
+    }
+
+    BenchClock::time_point start = BenchClock::now();
+    SphereBVH bvh;
+    bvh.build(x.data(), y.data(), z.data(), r.data(), plantCount);
+    double buildNs = elapsedNs(start);
+
+    //kamera krazy nad dnem i patrzy w strone rozgladania sie po scenie
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    std::vector<int> visible(plantCount);
+    double linearNs = 0.0, bvhNs = 0.0;
+    long long linearTotal = 0, bvhTotal = 0;
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        float angle = frame * 6.28318f / FRAMES;
+        glm::vec3 eye(std::cos(angle) * side * 0.25f, 0.0f, std::sin(angle) * side * 0.25f);
+        glm::vec3 target = eye + glm::vec3(-std::sin(angle), -0.2f, std::cos(angle));
+        Frustum frustum = extractFrustum(projection * glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f)));
+
+        start = BenchClock::now();
+        linearTotal += cullSpheres(frustum, x.data(), y.data(), z.data(), r.data(), plantCount, visible.data());
+        linearNs += elapsedNs(start);
+
+        start = BenchClock::now();
+        bvhTotal += bvh.cullFrustum(frustum, visible.data());
+        bvhNs += elapsedNs(start);
+    }
+
+    std::cout << "INFO: Culling: " << plantCount << " roslin, " << bvh.nodeCount() << " wezlow BVH, "
+              << FRAMES << " klatek" << std::endl;
+    std::cout << "  budowa BVH: " << buildNs / 1e6 << " ms" << std::endl;
+    std::cout << "  liniowo:    " << linearNs / FRAMES / 1e3 << " us/klatke (widoczne " << linearTotal / FRAMES << ")" << std::endl;
+    std::cout << "  BVH:        " << bvhNs / FRAMES / 1e3 << " us/klatke (widoczne " << bvhTotal / FRAMES << ")" << std::endl;
+    return linearTotal == bvhTotal ? 0 : 1;
+}
+
+int runLodBenchmark(const char* path)
+{
+    MeshData data;
+    if (!parseObj(path, data)) return 1;
+    int vertexCount = static_cast<int>(data.vertices.size() / MESH_VERTEX_FLOATS);
+    int fullCount = static_cast<int>(data.indices.size());
+
+    BenchClock::time_point start = BenchClock::now();
+    generateMeshLods(data);
+    double lodNs = elapsedNs(start);
+
+    //wyspy uv: skladowe spojne pelnej siatki po indeksach (szew = rozne wierzcholki w tym samym miejscu)
+    std::vector<int> chart(vertexCount);
+    std::iota(chart.begin(), chart.end(), 0);
+    auto find = [&chart](int v) {
+        while (chart[v] != v) v = chart[v] = chart[chart[v]];
+        return v;
+    };
+    for (int i = 0; i + 2 < fullCount; i += 3) {
+        chart[find(data.indices[i + 1])] = find(data.indices[i]);
+        chart[find(data.indices[i + 2])] = find(data.indices[i]);
+    }
+
+    //wierzcholek -> pierwszy o tej samej pozycji; nieruszony trojkat LOD-u ma te same indeksy co w LOD 0
+    std::vector<int> weld(vertexCount);
+    std::map<std::tuple<float, float, float>, int> positions;
+    int seamVertices = 0;
+    for (int v = 0; v < vertexCount; ++v) {
+        const float* p = &data.vertices[(size_t)v * MESH_VERTEX_FLOATS];
+        auto inserted = positions.emplace(std::make_tuple(p[0], p[1], p[2]), v);
+        weld[v] = inserted.first->second;
+        if (!inserted.second) seamVertices++;
+    }
+    auto sorted = [](int a, int b, int c) {
+        if (a > b) std::swap(a, b);
+        if (b > c) std::swap(b, c);
+        if (a > b) std::swap(a, b);
+        return std::make_tuple(a, b, c);
+    };
+    std::multimap<std::tuple<int, int, int>, std::tuple<int, int, int>> fullTriangles;
+    for (int i = 0; i + 2 < fullCount; i += 3) {
+        const unsigned int* t = &data.indices[i];
+        fullTriangles.emplace(sorted(weld[t[0]], weld[t[1]], weld[t[2]]), sorted(t[0], t[1], t[2]));
+    }
+
+    int mixedCharts = 0, changedTriangles = 0;
+    for (size_t l = 1; l < data.lods.size(); ++l) {
+        const MeshLod& lod = data.lods[l];
+        for (int i = lod.firstIndex; i + 2 < lod.firstIndex + lod.indexCount; i += 3) {
+            const unsigned int* t = &data.indices[i];
+            if (find(t[0]) != find(t[1]) || find(t[0]) != find(t[2])) mixedCharts++;
+            auto range = fullTriangles.equal_range(sorted(weld[t[0]], weld[t[1]], weld[t[2]]));
+            if (range.first == range.second) continue;
+            bool same = false;
+            for (auto it = range.first; it != range.second; ++it) same |= it->second == sorted(t[0], t[1], t[2]);
+            if (!same) changedTriangles++;
+        }
+    }
+
+    std::cout << "INFO: LOD: " << path << ", " << vertexCount << " wierzcholkow (" << seamVertices << " na szwach), trojkaty:";
+    for (size_t l = 0; l < data.lods.size(); ++l) std::cout << (l ? " -> " : " ") << data.lods[l].indexCount / 3;
+    std::cout << ", " << lodNs / 1e6 << " ms" << std::endl;
+    std::cout << "  trojkaty przez szew uv:        " << mixedCharts << std::endl;
+    std::cout << "  nieruszone z innymi indeksami: " << changedTriangles << std::endl;
+    return mixedCharts == 0 && changedTriangles == 0 ? 0 : 1;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#ifndef BENCHMARKS_CLASS_H
+#define BENCHMARKS_CLASS_H
+
+// Benchmarki CPU uruchamiane z linii polecen (bez okna i kontekstu GL).
+// Zwracaja kod wyjscia programu.
+
+// --bench-boids [liczba ryb]: budowa siatki, zapytanie o sasiadow i sterowanie lawica
+int runBoidsBenchmark(int fishCount);
+
+// --bench-jobs: narzut planisty zadan na jedno zadanie
+int runJobsBenchmark();
+
+// --bench-rng: Random/RandomBatch wzgledem rand()
+int runRandomBenchmark();
+
+// --bench-cull [liczba roslin]: frustum culling liniowy wzgledem statycznego BVH
+int runCullBenchmark(int plantCount);
+
+// --bench-lod [plik.obj]: lancuch LOD siatki; blad, gdy LOD gubi szwy uv/normalnych
+int runLodBenchmark(const char* path);
+
+#endif
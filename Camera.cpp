@@ -59,7 +59,19 @@ void Camera::MouseCallback(GLFWwindow* window, double xpos, double ypos)
 
     yaw += xoffset;
     pitch += yoffset;
+    updateOrientation();
+}
+
+void Camera::setPose(const glm::vec3& position, float yawDeg, float pitchDeg)
+{
+    Position = position;
+    yaw = yawDeg;
+    pitch = pitchDeg;
+    updateOrientation();
+}
 
+void Camera::updateOrientation()
+{
     if (pitch > 89.0f) pitch = 89.0f;
     if (pitch < -89.0f) pitch = -89.0f;
 
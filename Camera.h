@@ -42,5 +42,11 @@ public:
     void Inputs(GLFWwindow* window, float deltaTime);
 
     void MouseCallback(GLFWwindow* window, double xpos, double ypos);
+
+    // pozycja i kierunek z zewnatrz (sciezka kamery benchmarku), katy w stopniach
+    void setPose(const glm::vec3& position, float yawDeg, float pitchDeg);
+
+private:
+    void updateOrientation();
 };
 #endif
\ No newline at end of file
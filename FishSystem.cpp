@@ -0,0 +1,308 @@
+#include "FishSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FISH_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define FISH_TARGET_AVX2
+#else
+#define FISH_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define FISH_SIMD_X86 0
+#endif
+
+typedef void (*FishKernel)(float* x, float* y, float* z, const float* vx, float* vy, const float* vz,
+    int begin, int end, float step, float maxY, float despawnZ, std::vector<int>& despawned);
+
+//calkowanie, przyciecie do maxY (predkosc pionowa nie moze dalej rosnac), test respawnu
+static void integrateScalar(float* x, float* y, float* z, const float* vx, float* vy, const float* vz,
+    int begin, int end, float step, float maxY, float despawnZ, std::vector<int>& despawned)
+{
+    for (int i = begin; i < end; ++i) {
+        x[i] += vx[i] * step;
+        y[i] += vy[i] * step;
+        z[i] += vz[i] * step;
+        if (y[i] > maxY) {
+            y[i] = maxY;
+            vy[i] = std::min(vy[i], 0.0f);
+        }
+        if (z[i] < despawnZ)
+            despawned.push_back(i);
+    }
+}
+
+#if FISH_SIMD_X86
+static void integrateSSE(float* x, float* y, float* z, const float* vx, float* vy, const float* vz,
+    int begin, int end, float step, float maxY, float despawnZ, std::vector<int>& despawned)
+{
+    const __m128 s = _mm_set1_ps(step);
+    const __m128 top = _mm_set1_ps(maxY);
+    const __m128 limit = _mm_set1_ps(despawnZ);
+    const __m128 zero = _mm_setzero_ps();
+
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 vyv = _mm_loadu_ps(vy + i);
+        __m128 px = _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), s));
+        __m128 py = _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(vyv, s));
+        __m128 pz = _mm_add_ps(_mm_loadu_ps(z + i), _mm_mul_ps(_mm_loadu_ps(vz + i), s));
+
+        __m128 above = _mm_cmpgt_ps(py, top);
+        py = _mm_min_ps(py, top);
+        vyv = _mm_or_ps(_mm_and_ps(above, _mm_min_ps(vyv, zero)), _mm_andnot_ps(above, vyv));
+
+        _mm_storeu_ps(x + i, px);
+        _mm_storeu_ps(y + i, py);
+        _mm_storeu_ps(z + i, pz);
+        _mm_storeu_ps(vy + i, vyv);
+
+        int mask = _mm_movemask_ps(_mm_cmplt_ps(pz, limit));
+        for (int b = 0; mask != 0; ++b, mask >>= 1)
+            if (mask & 1) despawned.push_back(i + b);
+    }
+    integrateScalar(x, y, z, vx, vy, vz, i, end, step, maxY, despawnZ, despawned);
+}
+
+FISH_TARGET_AVX2
+static void integrateAVX2(float* x, float* y, float* z, const float* vx, float* vy, const float* vz,
+    int begin, int end, float step, float maxY, float despawnZ, std::vector<int>& despawned)
+{
+    const __m256 s = _mm256_set1_ps(step);
+    const __m256 top = _mm256_set1_ps(maxY);
+    const __m256 limit = _mm256_set1_ps(despawnZ);
+    const __m256 zero = _mm256_setzero_ps();
+
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 vyv = _mm256_loadu_ps(vy + i);
+        __m256 px = _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), s));
+        __m256 py = _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(vyv, s));
+        __m256 pz = _mm256_add_ps(_mm256_loadu_ps(z + i), _mm256_mul_ps(_mm256_loadu_ps(vz + i), s));
+
+        __m256 above = _mm256_cmp_ps(py, top, _CMP_GT_OQ);
+        py = _mm256_min_ps(py, top);
+        vyv = _mm256_blendv_ps(vyv, _mm256_min_ps(vyv, zero), above);
+
+        _mm256_storeu_ps(x + i, px);
+        _mm256_storeu_ps(y + i, py);
+        _mm256_storeu_ps(z + i, pz);
+        _mm256_storeu_ps(vy + i, vyv);
+
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(pz, limit, _CMP_LT_OQ));
+        for (int b = 0; mask != 0; ++b, mask >>= 1)
+            if (mask & 1) despawned.push_back(i + b);
+    }
+    integrateScalar(x, y, z, vx, vy, vz, i, end, step, maxY, despawnZ, despawned);
+}
+
+static bool cpuHasAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    //system musi zapisywac rejestry YMM
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+static FishKernel selectKernel(const char** name)
+{
+#if FISH_SIMD_X86
+    if (cpuHasAVX2()) { *name = "AVX2"; return integrateAVX2; }
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    *name = "SSE"; return integrateSSE;
+#endif
+#endif
+    *name = "scalar";
+    return integrateScalar;
+}
+
+static const char* kernelLabel = "scalar";
+static const FishKernel fishKernel = selectKernel(&kernelLabel);
+
+const char* FishSystem::kernelName()
+{
+    return kernelLabel;
+}
+
+FishSystem::FishSystem(const FishBounds& bounds, const BoidParams& boidParams, const Random& random)
+    : fishBounds(bounds), boids(boidParams), respawnRandom(random)
+{
+}
+
+int FishSystem::addSpecies(float speed)
+{
+    species.push_back({ size(), 0, speed });
+    return speciesCount() - 1;
+}
+
+void FishSystem::add(const glm::vec3& position, const glm::vec3& velocity, float fishYaw)
+{
+    if (species.empty()) addSpecies(1.0f);
+    x.push_back(position.x); y.push_back(position.y); z.push_back(position.z);
+    vx.push_back(velocity.x); vy.push_back(velocity.y); vz.push_back(velocity.z);
+    yaw.push_back(fishYaw);
+    species.back().count++;
+}
+
+void FishSystem::update(float timeScale, float cameraZ)
+{
+    despawned.clear();
+    for (const Species& s : species) {
+        if (s.count == 0) continue;
+        fishKernel(x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data(),
+            s.first, s.first + s.count, timeScale * s.speed, fishBounds.maxHeight, fishBounds.despawnZ, despawned);
+    }
+    if (despawned.empty()) return;
+
+    //respawn jest rzadki - skalarnie, liczby losowe jedna paczka
+    respawnFloats.resize(despawned.size() * 3);
+    respawnRandom.fillFloats(respawnFloats.data(), static_cast<int>(respawnFloats.size()));
+    for (size_t k = 0; k < despawned.size(); ++k) {
+        int i = despawned[k];
+        const float* r = &respawnFloats[k * 3];
+        x[i] = (r[0] - 0.5f) * 2.0f * fishBounds.spawnRadiusXZ;
+        y[i] = -9.0f + r[1] * 6.0f;
+        z[i] = cameraZ - fishBounds.spawnZOffset - r[2] * 10.0f;
+    }
+}
+
+void FishSystem::steer(float dt)
+{
+    for (int s = 0; s < speciesCount(); ++s)
+        steerSpecies(s, dt);
+}
+
+void FishSystem::steerSpecies(int s, float dt)
+{
+    prepareSteer(s);
+    steerSlots(0, neighbourGrid.pointCount(), dt);
+}
+
+void FishSystem::prepareSteer(int s)
+{
+    const int first = species[s].first;
+    const int count = species[s].count;
+
+    neighbourGrid.build(x.data(), y.data(), z.data(), first, count, boids.neighbourRadius);
+
+    //predkosci w kolejnosci slotow - odczyt sasiadow ciagly w pamieci
+    sortedVX.resize(count); sortedVY.resize(count); sortedVZ.resize(count);
+    for (int slot = 0; slot < count; ++slot) {
+        int f = neighbourGrid.order[slot];
+        sortedVX[slot] = vx[f]; sortedVY[slot] = vy[f]; sortedVZ[slot] = vz[f];
+    }
+}
+
+void FishSystem::steerSlots(int begin, int end, float dt)
+{
+    //czyta tylko kopie posortowane w prepareSteer, pisze vx/vy/vz/yaw wlasnych ryb
+    const SpatialGrid& g = neighbourGrid;
+    const float radius2 = boids.neighbourRadius * boids.neighbourRadius;
+    const float separation2 = boids.separationRadius * boids.separationRadius;
+
+    SpatialGrid::SlotRange ranges[27];
+    int rangeCount = 0;
+    int lastCx = 0, lastCy = 0, lastCz = 0;
+    bool haveCell = false;
+
+    for (int slot = begin; slot < end; ++slot) {
+        const float px = g.sortedX[slot], py = g.sortedY[slot], pz = g.sortedZ[slot];
+        const float ux = sortedVX[slot], uy = sortedVY[slot], uz = sortedVZ[slot];
+
+        //kolejne sloty zwykle leza w tej samej komorce - zakresy z poprzedniego
+        int cx = g.cellCoord(px), cy = g.cellCoord(py), cz = g.cellCoord(pz);
+        if (!haveCell || cx != lastCx || cy != lastCy || cz != lastCz) {
+            rangeCount = g.neighbourRanges(cx, cy, cz, ranges);
+            lastCx = cx; lastCy = cy; lastCz = cz;
+            haveCell = true;
+        }
+
+        float sepX = 0.0f, sepY = 0.0f, sepZ = 0.0f;
+        float aliX = 0.0f, aliY = 0.0f, aliZ = 0.0f;
+        float cohX = 0.0f, cohY = 0.0f, cohZ = 0.0f;
+        int neighbours = 0;
+        for (int r = 0; r < rangeCount && neighbours < boids.maxNeighbours; ++r) {
+            for (int j = ranges[r].begin; j < ranges[r].end; ++j) {
+                if (j == slot) continue;
+                float dx = px - g.sortedX[j], dy = py - g.sortedY[j], dz = pz - g.sortedZ[j];
+                float d2 = dx * dx + dy * dy + dz * dz;
+                if (d2 >= radius2) continue;
+                if (d2 < separation2 && d2 > 1e-8f) {
+                    float inv = 1.0f / d2;
+                    sepX += dx * inv; sepY += dy * inv; sepZ += dz * inv;
+                }
+                aliX += sortedVX[j]; aliY += sortedVY[j]; aliZ += sortedVZ[j];
+                cohX += g.sortedX[j]; cohY += g.sortedY[j]; cohZ += g.sortedZ[j];
+                if (++neighbours >= boids.maxNeighbours) break;
+            }
+        }
+
+        float ax = 0.0f, ay = 0.0f, az = 0.0f;
+        if (neighbours > 0) {
+            float inv = 1.0f / neighbours;
+            ax = boids.separationWeight * sepX + boids.alignmentWeight * (aliX * inv - ux) + boids.cohesionWeight * (cohX * inv - px);
+            ay = boids.separationWeight * sepY + boids.alignmentWeight * (aliY * inv - uy) + boids.cohesionWeight * (cohY * inv - py);
+            az = boids.separationWeight * sepZ + boids.alignmentWeight * (aliZ * inv - uz) + boids.cohesionWeight * (cohZ * inv - pz);
+        }
+        //miekkie granice wysokosci: dno i powierzchnia
+        if (py < boids.minHeight) ay += boids.boundWeight * (boids.minHeight - py);
+        if (py > fishBounds.maxHeight - 0.5f) ay -= boids.boundWeight;
+
+        float nx = ux + ax * dt, ny = uy + ay * dt, nz = uz + az * dt;
+        ny = std::max(-boids.maxVerticalSpeed, std::min(ny, boids.maxVerticalSpeed));
+        //predkosc jednostkowa jak przy spawnie; tempo gatunku doklada update()
+        float len = std::sqrt(nx * nx + ny * ny + nz * nz);
+        if (len < 1e-6f) { nx = ux; ny = uy; nz = uz; len = 1.0f; }
+        float invLen = 1.0f / len;
+
+        int f = g.order[slot];
+        vx[f] = nx * invLen; vy[f] = ny * invLen; vz[f] = nz * invLen;
+        yaw[f] = std::atan2(vx[f], vz[f]);
+    }
+}
+
+void FishSystem::writeInstances(int s, FishInstanceGPU* out) const
+{
+    const int first = species[s].first;
+    const int count = species[s].count;
+    float* dst = reinterpret_cast<float*>(out);
+    int i = 0;
+#if FISH_SIMD_X86 && (defined(__SSE2__) || defined(_M_X64))
+    //4 ryby naraz: transpozycja SoA -> AoS (x y z yaw)
+    for (; i + 4 <= count; i += 4) {
+        __m128 r0 = _mm_loadu_ps(&x[first + i]);
+        __m128 r1 = _mm_loadu_ps(&y[first + i]);
+        __m128 r2 = _mm_loadu_ps(&z[first + i]);
+        __m128 r3 = _mm_loadu_ps(&yaw[first + i]);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(dst + 4 * i + 0, r0);
+        _mm_storeu_ps(dst + 4 * i + 4, r1);
+        _mm_storeu_ps(dst + 4 * i + 8, r2);
+        _mm_storeu_ps(dst + 4 * i + 12, r3);
+    }
+#endif
+    for (; i < count; ++i) {
+        int f = first + i;
+        dst[4 * i + 0] = x[f];
+        dst[4 * i + 1] = y[f];
+        dst[4 * i + 2] = z[f];
+        dst[4 * i + 3] = yaw[f];
+    }
+}
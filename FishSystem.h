@@ -0,0 +1,101 @@
+#pragma once
+#ifndef FISH_SYSTEM_CLASS_H
+#define FISH_SYSTEM_CLASS_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Random.h"
+#include "SpatialGrid.h"
+
+//dane instancji ryby w buforze: xyz = pozycja, w = yaw
+struct FishInstanceGPU {
+    glm::vec4 positionYaw;
+};
+
+// Granice ruchu ryb i obszar respawnu.
+struct FishBounds
+{
+    float maxHeight = -0.5f;        //ryby nie wyplywaja ponad te wysokosc
+    float despawnZ = -120.0f;       //po przekroczeniu - respawn
+    float spawnRadiusXZ = 15.0f;
+    float spawnZOffset = 5.0f;      //respawn na (kamera.z - offset)
+};
+
+// Parametry lawicy (boids: separacja, wyrownanie, spojnosc).
+struct BoidParams
+{
+    float neighbourRadius = 2.0f;       //rowniez rozmiar komorki siatki
+    float separationRadius = 0.7f;
+    float separationWeight = 2.0f;
+    float alignmentWeight = 1.0f;
+    float cohesionWeight = 0.5f;
+    int   maxNeighbours = 16;           //gorne ograniczenie kosztu w gestych lawicach
+    float maxVerticalSpeed = 0.3f;
+    float minHeight = -9.5f;            //tuz nad dnem
+    float boundWeight = 2.0f;
+};
+
+// Symulacja ryb w ukladzie SoA: osobne tablice x/y/z/vx/vy/vz/yaw.
+// Ryby jednego gatunku leza w ciaglym zakresie [first, first + count).
+// Krok (calkowanie, przyciecie do maxHeight, test respawnu) liczy kernel
+// AVX2 lub SSE wybrany przy starcie, ze skalarnym zapasem.
+class FishSystem
+{
+public:
+    // random: strumien dla respawnu (wynik zalezy tylko od ziarna)
+    explicit FishSystem(const FishBounds& bounds = FishBounds(), const BoidParams& boids = BoidParams(),
+        const Random& random = Random());
+
+    // nowy gatunek; kolejne add() trafiaja do niego
+    int addSpecies(float speed);
+    void add(const glm::vec3& position, const glm::vec3& velocity, float yaw);
+
+    // sterowanie lawica: nowe predkosci i yaw; sasiedzi z siatki przebudowanej
+    // dla kazdego gatunku (ryby lacza sie w lawice tylko z wlasnym gatunkiem)
+    void steer(float dt);
+    void steerSpecies(int species, float dt);
+    // ta sama praca w dwoch fazach: siatka gatunku (raz), potem dowolne
+    // rozlaczne zakresy slotow [begin, end) rownolegle na roznych watkach
+    void prepareSteer(int species);
+    void steerSlots(int begin, int end, float dt);
+
+    // timeScale mnozy predkosc ryb (globalna szybkosc * dt * 60)
+    void update(float timeScale, float cameraZ);
+
+    // przeplata x/y/z/yaw gatunku do bufora instancji; out: speciesSize(species) elementow
+    void writeInstances(int species, FishInstanceGPU* out) const;
+
+    int speciesCount() const { return static_cast<int>(species.size()); }
+    int speciesFirst(int s) const { return species[s].first; }
+    int speciesSize(int s) const { return species[s].count; }
+    int size() const { return static_cast<int>(x.size()); }
+    const SpatialGrid& grid() const { return neighbourGrid; }
+    BoidParams& boidParams() { return boids; }
+
+    // nazwa uzytego kernela: "AVX2", "SSE" albo "scalar"
+    static const char* kernelName();
+
+    std::vector<float> x, y, z;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> yaw;
+
+private:
+    struct Species
+    {
+        int   first;
+        int   count;
+        float speed;
+    };
+
+    FishBounds fishBounds;
+    BoidParams boids;
+    SpatialGrid neighbourGrid;
+    std::vector<float> sortedVX, sortedVY, sortedVZ;
+    std::vector<Species> species;
+    std::vector<int> despawned;     //indeksy z ostatniego kroku, bufor wielokrotnego uzytku
+    RandomBatch respawnRandom;
+    std::vector<float> respawnFloats;
+};
+
+#endif
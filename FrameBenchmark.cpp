@@ -0,0 +1,269 @@
+#include "FrameBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "Trace.h"
+
+CameraPath CameraPath::flythrough()
+{
+    //start nad woda, zejscie do raf, petla nad dnem i powrot; yaw -360 na okrazenie
+    CameraPath path;
+    path.keys = {
+        {  0.0f, glm::vec3(  0.0f,  8.0f,  15.0f),  -90.0f, -10.0f },
+        {  4.0f, glm::vec3(  0.0f, -4.0f, -10.0f),  -90.0f, -15.0f },
+        {  8.0f, glm::vec3( 25.0f, -7.0f, -50.0f), -110.0f,  -5.0f },
+        { 12.0f, glm::vec3( 60.0f, -6.0f, -20.0f), -200.0f,   0.0f },
+        { 16.0f, glm::vec3( 20.0f, -5.0f,  30.0f), -270.0f,  -5.0f },
+        { 20.0f, glm::vec3(-20.0f,  0.0f,  20.0f), -330.0f,  10.0f },
+        { 24.0f, glm::vec3(  0.0f,  8.0f,  15.0f), -450.0f, -10.0f },
+    };
+    return path;
+}
+
+bool CameraPath::load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "ERROR: nie mozna otworzyc sciezki kamery " << path << std::endl;
+        return false;
+    }
+    keys.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream in(line);
+        CameraKey key;
+        if (in >> key.time >> key.position.x >> key.position.y >> key.position.z >> key.yaw >> key.pitch)
+            keys.push_back(key);
+    }
+    //czasy musza rosnac - inaczej szukanie segmentu nie ma sensu
+    for (size_t i = 1; i < keys.size(); ++i) {
+        if (keys[i].time <= keys[i - 1].time) {
+            std::cerr << "ERROR: sciezka kamery " << path << " - czasy nie rosna (wiersz " << i + 1 << ")" << std::endl;
+            keys.clear();
+            return false;
+        }
+    }
+    if (keys.size() < 2) {
+        std::cerr << "ERROR: sciezka kamery " << path << " - potrzeba co najmniej 2 punktow" << std::endl;
+        keys.clear();
+        return false;
+    }
+    return true;
+}
+
+bool CameraPath::save(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "ERROR: nie mozna zapisac sciezki kamery " << path << std::endl;
+        return false;
+    }
+    file << "# czas x y z yaw pitch\n";
+    for (const CameraKey& key : keys)
+        file << key.time << ' ' << key.position.x << ' ' << key.position.y << ' ' << key.position.z
+             << ' ' << key.yaw << ' ' << key.pitch << '\n';
+    return static_cast<bool>(file);
+}
+
+static float catmullRom(float p0, float p1, float p2, float p3, float t)
+{
+    float t2 = t * t, t3 = t2 * t;
+    return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2
+        + (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
+
+CameraKey CameraPath::sample(float time) const
+{
+    if (keys.empty()) return { time, glm::vec3(0.0f), -90.0f, 0.0f };
+    if (keys.size() == 1) return keys[0];
+
+    float length = duration() - keys[0].time;
+    float local = time - keys[0].time;
+    float laps = std::floor(local / length);
+    local -= laps * length;
+    float yawPerLap = keys.back().yaw - keys.front().yaw;
+
+    size_t i = 0;
+    while (i + 2 < keys.size() && keys[i + 1].time - keys[0].time <= local) ++i;
+    const CameraKey& k1 = keys[i];
+    const CameraKey& k2 = keys[i + 1];
+    const CameraKey& k0 = keys[i > 0 ? i - 1 : i];
+    const CameraKey& k3 = keys[std::min(i + 2, keys.size() - 1)];
+    float t = std::clamp((local - (k1.time - keys[0].time)) / (k2.time - k1.time), 0.0f, 1.0f);
+
+    CameraKey key;
+    key.time = time;
+    for (int c = 0; c < 3; ++c)
+        key.position[c] = catmullRom(k0.position[c], k1.position[c], k2.position[c], k3.position[c], t);
+    key.yaw = catmullRom(k0.yaw, k1.yaw, k2.yaw, k3.yaw, t) + laps * yawPerLap;
+    key.pitch = catmullRom(k0.pitch, k1.pitch, k2.pitch, k3.pitch, t);
+    return key;
+}
+
+void BenchmarkCounter::add(double value)
+{
+    sum += value;
+    max = std::max(max, value);
+    frames++;
+}
+
+static void writeStats(std::ostream& out, const ProfilerStats& s)
+{
+    out << "{\"min\": " << s.min << ", \"avg\": " << s.avg << ", \"p50\": " << s.p50 << ", \"p90\": " << s.p90
+        << ", \"p99\": " << s.p99 << ", \"max\": " << s.max << ", \"samples\": " << s.samples << "}";
+}
+
+bool writeBenchmarkReport(const std::string& path, const BenchmarkConfig& config, const Profiler& profiler,
+    const BenchmarkCounters& counters)
+{
+    const BenchmarkCounter& drawCalls = counters.drawCalls;
+    const BenchmarkCounter& triangles = counters.triangles;
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "ERROR: nie mozna zapisac raportu " << path << std::endl;
+        return false;
+    }
+    out << std::fixed << std::setprecision(4);
+    out << "{\n";
+    out << "  \"seed\": " << config.seed << ",\n";
+    out << "  \"warmupFrames\": " << config.warmupFrames << ",\n";
+    out << "  \"measuredFrames\": " << config.measuredFrames << ",\n";
+    out << "  \"frameTime\": " << config.frameTime << ",\n";
+    out << "  \"resolution\": [" << config.width << ", " << config.height << "],\n";
+    out << "  \"glVersion\": " << jsonString(config.glVersion) << ",\n";
+    out << "  \"renderer\": " << jsonString(config.renderer) << ",\n";
+    out << "  \"cameraPath\": " << jsonString(config.cameraPath) << ",\n";
+    out << "  \"culling\": " << jsonString(config.culling) << ",\n";
+    const SceneConfig& scene = config.scene;
+    out << "  \"scene\": {\"fish\": " << config.fishCount << ", \"fishGroupsPerType\": " << scene.fishGroupsPerType
+        << ", \"plants\": " << config.plantCount << ", \"bubbles\": " << scene.bubbles
+        << ", \"oceanGridHalf\": " << scene.oceanGridHalf << ", \"groundResolution\": " << scene.groundResolution << "},\n";
+    out << "  \"frameMs\": ";
+    writeStats(out, profiler.frameStats());
+    out << ",\n  \"passes\": [";
+    const std::vector<Profiler::Stage>& stages = profiler.stages();
+    for (size_t i = 0; i < stages.size(); ++i) {
+        out << (i ? ",\n" : "\n") << "    {\"name\": " << jsonString(stages[i].name) << ", \"cpuMs\": ";
+        writeStats(out, stages[i].cpu.stats());
+        ProfilerStats gpu = stages[i].gpu.stats();
+        if (gpu.samples > 0) {
+            out << ", \"gpuMs\": ";
+            writeStats(out, gpu);
+        }
+        out << "}";
+    }
+    out << "\n  ],\n";
+    out << "  \"simulationMs\": {\"avg\": " << counters.simulationMs.avg() << ", \"max\": " << counters.simulationMs.max << "},\n";
+    out << "  \"drawCalls\": {\"avg\": " << drawCalls.avg() << ", \"max\": " << drawCalls.max << "},\n";
+    //przy cullingu na GPU trojkaty zna tylko GPU - brak probek
+    out << "  \"triangles\": {\"avg\": " << triangles.avg() << ", \"max\": " << triangles.max
+        << ", \"frames\": " << triangles.frames << "}\n";
+    out << "}\n";
+    std::cout << "INFO: Raport benchmarku zapisany do " << path << std::endl;
+    return static_cast<bool>(out);
+}
+
+static const char* SWEEP_HEADER =
+    "subsystem,size,status,fish,plants,bubbles,ocean_grid,ground,frame_avg_ms,frame_p99_ms,"
+    "simulation_ms,submit_ms,gpu_ms,draw_calls,triangles\n";
+
+static bool openSweepCsv(const std::string& path, std::ofstream& out)
+{
+    std::ifstream existing(path);
+    bool empty = !existing || existing.peek() == std::ifstream::traits_type::eof();
+    existing.close();
+    out.open(path, std::ios::app);
+    if (!out) {
+        std::cerr << "ERROR: nie mozna zapisac " << path << std::endl;
+        return false;
+    }
+    if (empty) out << SWEEP_HEADER;
+    return true;
+}
+
+bool appendSweepRow(const std::string& path, const std::string& subsystem, int size, const BenchmarkConfig& config,
+    const Profiler& profiler, const BenchmarkCounters& counters)
+{
+    std::ofstream out;
+    if (!openSweepCsv(path, out)) return false;
+
+    //etapy poza wysylaniem komend: wejscie, czekanie na symulacje, swap
+    double submitMs = 0.0, gpuMs = 0.0;
+    for (const Profiler::Stage& stage : profiler.stages()) {
+        bool submit = strcmp(stage.name, "input") != 0 && strcmp(stage.name, "simulation") != 0
+            && strcmp(stage.name, "swap") != 0;
+        if (submit) submitMs += stage.cpu.stats().avg;
+        gpuMs += stage.gpu.stats().avg;
+    }
+    ProfilerStats frame = profiler.frameStats();
+    const SceneConfig& scene = config.scene;
+    out << std::fixed << std::setprecision(4)
+        << subsystem << ',' << size << ",ok," << config.fishCount << ',' << config.plantCount << ',' << scene.bubbles << ','
+        << 2 * scene.oceanGridHalf << ',' << scene.groundResolution << ',' << frame.avg << ',' << frame.p99 << ','
+        << counters.simulationMs.avg() << ',' << submitMs << ',' << gpuMs << ',' << counters.drawCalls.avg() << ','
+        << counters.triangles.avg() << '\n';
+    return static_cast<bool>(out);
+}
+
+int runSceneSweep(const std::string& executable, const std::string& subsystem, const std::string& csvPath,
+    int warmupFrames, int measuredFrames)
+{
+    struct SweepRun { std::string subsystem; int size; std::string args; };
+    std::vector<SweepRun> runs;
+    SceneConfig defaults;
+    bool all = subsystem == "all";
+
+    //ryby: docelowa liczba -> lawice na gatunek (3 gatunki)
+    if (all || subsystem == "fish") {
+        for (int fish : { 1000, 3000, 10000, 30000, 100000, 300000, 1000000 }) {
+            int groups = std::max(1, static_cast<int>(std::lround(fish / (3.0f * defaults.averageGroupSize()))));
+            runs.push_back({ "fish", fish, "--fish-groups " + std::to_string(groups) });
+        }
+    }
+    //rosliny: lacznie na 4 typy
+    if (all || subsystem == "plants") {
+        for (int plants : { 1000, 5000, 20000, 50000, 100000, 200000, 500000 })
+            runs.push_back({ "plants", plants, "--plants-per-type " + std::to_string(plants / 4) });
+    }
+    //ocean: bok siatki poziomu clipmapy
+    if (all || subsystem == "ocean") {
+        for (int grid : { 64, 128, 256, 512, 1024 })
+            runs.push_back({ "ocean", grid, "--ocean-grid " + std::to_string(grid) });
+    }
+    if (runs.empty()) {
+        std::cerr << "ERROR: --sweep " << subsystem << " - oczekiwano fish, plants, ocean albo all" << std::endl;
+        return 1;
+    }
+
+    std::remove(csvPath.c_str());
+    int failed = 0;
+    for (const SweepRun& run : runs) {
+        std::string command = "\"" + executable + "\" --headless --benchmark --seed 1"
+            + " --warmup " + std::to_string(warmupFrames) + " --frames " + std::to_string(measuredFrames)
+            + " --benchmark-out sweep_last.json " + run.args
+            + " --sweep-row \"" + csvPath + "\" " + run.subsystem + " " + std::to_string(run.size);
+#ifdef _WIN32
+        //cmd.exe zdejmuje zewnetrzne cudzyslowy z calego polecenia
+        command = "\"" + command + "\"";
+#endif
+        std::cout << "INFO: Sweep " << run.subsystem << " " << run.size << std::endl;
+        if (std::system(command.c_str()) != 0) {
+            std::cerr << "ERROR: Sweep " << run.subsystem << " " << run.size << " nieudany" << std::endl;
+            std::ofstream out;
+            if (openSweepCsv(csvPath, out))
+                out << run.subsystem << ',' << run.size << ",failed,,,,,,,,,,,,\n";
+            failed++;
+        }
+    }
+    std::cout << "INFO: Sweep - " << runs.size() - failed << "/" << runs.size() << " przebiegow, wyniki w " << csvPath << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#ifndef FRAME_BENCHMARK_CLASS_H
+#define FRAME_BENCHMARK_CLASS_H
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+#include "Profiler.h"
+#include "SceneConfig.h"
+
+// Punkt sciezki kamery: czas (s), pozycja i katy jak w Camera (stopnie)
+struct CameraKey
+{
+    float time;
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+// Sciezka kamery benchmarku - splajn Catmulla-Roma przez punkty kluczowe.
+// Czas poza [0, duration()] jest zawijany, a yaw narasta o roznice
+// miedzy ostatnim i pierwszym kluczem na kazde okrazenie.
+class CameraPath
+{
+public:
+    std::vector<CameraKey> keys;
+
+    // wbudowany przelot nad i miedzy rafami, zamkniety (koniec = poczatek)
+    static CameraPath flythrough();
+
+    // plik tekstowy: "czas x y z yaw pitch" w wierszu, '#' - komentarz
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    float duration() const { return keys.empty() ? 0.0f : keys.back().time; }
+    CameraKey sample(float time) const;
+};
+
+// Liczniki zbierane co mierzona klatke
+struct BenchmarkCounter
+{
+    double sum = 0.0;
+    double max = 0.0;
+    int frames = 0;
+
+    void add(double value);
+    double avg() const { return frames ? sum / frames : 0.0; }
+};
+
+struct BenchmarkCounters
+{
+    BenchmarkCounter drawCalls;
+    BenchmarkCounter triangles;     // tylko klatki z cullingiem na CPU
+    BenchmarkCounter simulationMs;  // krok symulacji w tle (Simulation::lastStepMs)
+};
+
+// Opis przebiegu zapisywany w raporcie, zeby porownywac tylko zgodne przebiegi
+struct BenchmarkConfig
+{
+    unsigned long long seed = 0;
+    int warmupFrames = 0;
+    int measuredFrames = 0;
+    float frameTime = 0.0f;
+    int width = 0;
+    int height = 0;
+    std::string glVersion;
+    std::string renderer;
+    std::string cameraPath;
+    std::string culling;
+    SceneConfig scene;
+    int fishCount = 0;
+    int plantCount = 0;
+};
+
+// Raport JSON: percentyle czasu klatki, czasy etapow CPU/GPU z profilera
+// (profiler z historia >= measuredFrames i wyzerowany po rozgrzewce),
+// liczniki draw calli, trojkatow i czasu symulacji
+bool writeBenchmarkReport(const std::string& path, const BenchmarkConfig& config, const Profiler& profiler,
+    const BenchmarkCounters& counters);
+
+// Wiersz CSV przebiegu --sweep (naglowek, gdy plik jest pusty). Wysylanie =
+// suma CPU etapow renderu (bez input, simulation, swap), GPU = suma etapow GPU.
+bool appendSweepRow(const std::string& path, const std::string& subsystem, int size, const BenchmarkConfig& config,
+    const Profiler& profiler, const BenchmarkCounters& counters);
+
+// --sweep fish|plants|ocean|all: kazdy rozmiar to osobny proces
+// `executable --headless --benchmark ...` dopisujacy wiersz do csvPath,
+// wiec scena i zasoby GL sa budowane od zera. Przebieg, ktory sie nie
+// powiodl (np. brak pamieci), dostaje wiersz ze statusem "failed".
+int runSceneSweep(const std::string& executable, const std::string& subsystem, const std::string& csvPath,
+    int warmupFrames, int measuredFrames);
+
+#endif
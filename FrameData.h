@@ -0,0 +1,42 @@
+#pragma once
+#ifndef FRAME_DATA_CLASS_H
+#define FRAME_DATA_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// Punkt wiazania bloku FrameData wspolny dla wszystkich programow.
+const GLuint FRAME_DATA_BINDING = 0;
+
+// Dane kamery i swiatla, raz na klatke. Uklad std140 musi odpowiadac
+// blokowi "uniform FrameData" w shaderach (vec3 wyrownany do 16 bajtow).
+struct FrameData
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec3 viewPos;
+    float     time;
+    glm::vec3 lightPos;
+    float     pad0;
+    glm::vec3 lightColor;
+    float     pad1;
+};
+
+static_assert(offsetof(FrameData, viewPos) == 128, "FrameData: niezgodny uklad std140");
+static_assert(offsetof(FrameData, lightPos) == 144, "FrameData: niezgodny uklad std140");
+static_assert(offsetof(FrameData, lightColor) == 160, "FrameData: niezgodny uklad std140");
+static_assert(sizeof(FrameData) == 176, "FrameData: niezgodny uklad std140");
+
+class FrameUniformBuffer
+{
+public:
+    GLuint ID = 0;
+
+    FrameUniformBuffer();
+
+    void update(const FrameData& data);
+    void Delete();
+};
+
+#endif
@@ -0,0 +1,128 @@
+#include "Frustum.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_SSE 1
+#include <emmintrin.h>
+#else
+#define FRUSTUM_SSE 0
+#endif
+
+Frustum extractFrustum(const glm::mat4& m)
+{
+    //glm: m[kolumna][wiersz]
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum f;
+    f.planes[0] = row3 + row0;  //lewa
+    f.planes[1] = row3 - row0;  //prawa
+    f.planes[2] = row3 + row1;  //dolna
+    f.planes[3] = row3 - row1;  //gorna
+    f.planes[4] = row3 + row2;  //bliska
+    f.planes[5] = row3 - row2;  //daleka
+    for (glm::vec4& p : f.planes) {
+        float length = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        p = p * (1.0f / length);
+    }
+    return f;
+}
+
+bool sphereInFrustum(const Frustum& frustum, const glm::vec3& c, float radius)
+{
+    for (const glm::vec4& p : frustum.planes)
+        if (p.x * c.x + p.y * c.y + p.z * c.z + p.w < -radius) return false;
+    return true;
+}
+
+FrustumOverlap classifyBox(const Frustum& frustum, const glm::vec3& boxMin, const glm::vec3& boxMax)
+{
+    //srodek i polowa rozmiaru: odleglosc srodka i rzut polowy na normalna
+    glm::vec3 center = (boxMin + boxMax) * 0.5f;
+    glm::vec3 extent = (boxMax - boxMin) * 0.5f;
+    FrustumOverlap result = FRUSTUM_INSIDE;
+    for (const glm::vec4& p : frustum.planes) {
+        float d = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+        float r = std::fabs(p.x) * extent.x + std::fabs(p.y) * extent.y + std::fabs(p.z) * extent.z;
+        if (d < -r) return FRUSTUM_OUTSIDE;
+        if (d < r) result = FRUSTUM_INTERSECT;
+    }
+    return result;
+}
+
+int cullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+    int count, int* visible)
+{
+    int n = 0;
+    int i = 0;
+#if FRUSTUM_SSE
+    __m128 px[6], py[6], pz[6], pw[6];
+    for (int k = 0; k < 6; ++k) {
+        px[k] = _mm_set1_ps(frustum.planes[k].x);
+        py[k] = _mm_set1_ps(frustum.planes[k].y);
+        pz[k] = _mm_set1_ps(frustum.planes[k].z);
+        pw[k] = _mm_set1_ps(frustum.planes[k].w);
+    }
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 cx = _mm_loadu_ps(x + i), cy = _mm_loadu_ps(y + i), cz = _mm_loadu_ps(z + i);
+        __m128 negR = _mm_sub_ps(zero, _mm_loadu_ps(radius + i));
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int k = 0; k < 6; ++k) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[k], cx), _mm_mul_ps(py[k], cy)),
+                _mm_add_ps(_mm_mul_ps(pz[k], cz), pw[k]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+        }
+        int mask = _mm_movemask_ps(inside);
+        for (int b = 0; mask != 0; ++b, mask >>= 1)
+            if (mask & 1) visible[n++] = i + b;
+    }
+#endif
+    for (; i < count; ++i)
+        if (sphereInFrustum(frustum, glm::vec3(x[i], y[i], z[i]), radius[i])) visible[n++] = i;
+    return n;
+}
+
+int cullInstances(const Frustum& frustum, const glm::vec4* instances, int count, float radius, glm::vec4* out)
+{
+    int n = 0;
+    int i = 0;
+#if FRUSTUM_SSE
+    __m128 px[6], py[6], pz[6], pw[6];
+    for (int k = 0; k < 6; ++k) {
+        px[k] = _mm_set1_ps(frustum.planes[k].x);
+        py[k] = _mm_set1_ps(frustum.planes[k].y);
+        pz[k] = _mm_set1_ps(frustum.planes[k].z);
+        pw[k] = _mm_set1_ps(frustum.planes[k].w);
+    }
+    const __m128 negR = _mm_set1_ps(-radius);
+    const float* src = reinterpret_cast<const float*>(instances);
+    for (; i + 4 <= count; i += 4) {
+        //AoS -> SoA dla 4 instancji
+        __m128 r0 = _mm_loadu_ps(src + 4 * i + 0);
+        __m128 r1 = _mm_loadu_ps(src + 4 * i + 4);
+        __m128 r2 = _mm_loadu_ps(src + 4 * i + 8);
+        __m128 r3 = _mm_loadu_ps(src + 4 * i + 12);
+        __m128 cx = r0, cy = r1, cz = r2, cw = r3;
+        _MM_TRANSPOSE4_PS(cx, cy, cz, cw);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int k = 0; k < 6; ++k) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[k], cx), _mm_mul_ps(py[k], cy)),
+                _mm_add_ps(_mm_mul_ps(pz[k], cz), pw[k]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+        }
+        int mask = _mm_movemask_ps(inside);
+        if (mask & 1) out[n++] = instances[i + 0];
+        if (mask & 2) out[n++] = instances[i + 1];
+        if (mask & 4) out[n++] = instances[i + 2];
+        if (mask & 8) out[n++] = instances[i + 3];
+    }
+#endif
+    for (; i < count; ++i)
+        if (sphereInFrustum(frustum, glm::vec3(instances[i]), radius)) out[n++] = instances[i];
+    return n;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#ifndef FRUSTUM_CLASS_H
+#define FRUSTUM_CLASS_H
+
+#include <glm/glm.hpp>
+
+// Szesc plaszczyzn ostroslupa widzenia (nx, ny, nz, d), normalne do srodka:
+// punkt p jest po dobrej stronie, gdy dot(n, p) + d >= 0.
+struct Frustum
+{
+    glm::vec4 planes[6];
+};
+
+// Gribb-Hartmann: plaszczyzny z wierszy macierzy projection * view
+Frustum extractFrustum(const glm::mat4& viewProjection);
+
+bool sphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius);
+
+// Wynik testu prostopadloscianu: calkiem poza, przecina brzeg, calkiem wewnatrz
+enum FrustumOverlap
+{
+    FRUSTUM_OUTSIDE,
+    FRUSTUM_INTERSECT,
+    FRUSTUM_INSIDE
+};
+
+// AABB [boxMin, boxMax]; "wewnatrz" pozwala pominac testy wszystkiego co w srodku
+FrustumOverlap classifyBox(const Frustum& frustum, const glm::vec3& boxMin, const glm::vec3& boxMax);
+
+// Sfery w ukladzie SoA, po 4 naraz (SSE). Indeksy widocznych trafiaja do
+// visible (miejsce na count elementow); zwraca ich liczbe.
+int cullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+    int count, int* visible);
+
+// Instancje (xyz = srodek, w = dowolne) o wspolnym promieniu; widoczne sa
+// kopiowane po kolei do out (moze byc zmapowany bufor GL). Zwraca ich liczbe.
+int cullInstances(const Frustum& frustum, const glm::vec4* instances, int count, float radius, glm::vec4* out);
+
+// Liczniki do tytulu okna / statystyk
+struct CullStats
+{
+    int tested = 0;
+    int visible = 0;
+
+    void add(int testedCount, int visibleCount) { tested += testedCount; visible += visibleCount; }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "GerstnerWaves.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+GerstnerWaves::GerstnerWaves()
+{
+    waves = {
+        { glm::vec2(1.0f, 0.5f),   0.2f,  15.0f, 1.0f },
+        { glm::vec2(-0.3f, 0.8f),  0.1f,  5.0f,  1.5f },
+        { glm::vec2(0.5f, -0.5f),  0.05f, 2.0f,  0.8f },
+    };
+}
+
+void GerstnerWaves::bind(const Shader& shader)
+{
+    for (int i = 0; i < MAX_GERSTNER_WAVES; ++i) {
+        std::string prefix = "waves[" + std::to_string(i) + "].";
+        handles[i].direction = shader.uniform(prefix + "direction");
+        handles[i].steepness = shader.uniform(prefix + "steepness");
+        handles[i].wavelength = shader.uniform(prefix + "wavelength");
+        handles[i].speed = shader.uniform(prefix + "speed");
+    }
+    waveCountLoc = shader.uniform("waveCount");
+}
+
+void GerstnerWaves::upload(const Shader& shader) const
+{
+    int count = std::min(static_cast<int>(waves.size()), MAX_GERSTNER_WAVES);
+    if (static_cast<int>(waves.size()) > MAX_GERSTNER_WAVES)
+        std::cerr << "ERROR: Za duzo fal Gerstnera (" << waves.size() << "), uzyte " << MAX_GERSTNER_WAVES << std::endl;
+
+    for (int i = 0; i < count; ++i) {
+        shader.setVec2(handles[i].direction, glm::normalize(waves[i].direction));
+        shader.setFloat(handles[i].steepness, waves[i].steepness);
+        shader.setFloat(handles[i].wavelength, waves[i].wavelength);
+        shader.setFloat(handles[i].speed, waves[i].speed);
+    }
+    shader.setInt(waveCountLoc, count);
+}
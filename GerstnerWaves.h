@@ -0,0 +1,48 @@
+#pragma once
+#ifndef GERSTNER_WAVES_CLASS_H
+#define GERSTNER_WAVES_CLASS_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "shaderClass.h"
+
+// Musi odpowiadac MAX_WAVES w ocean.vert.
+const int MAX_GERSTNER_WAVES = 8;
+
+struct GerstnerWave
+{
+    glm::vec2 direction;
+    float     steepness;
+    float     wavelength;
+    float     speed;
+};
+
+// Fale Gerstnera oceanu: parametry trzymane po stronie CPU, wysylane
+// do tablicy uniformow "waves[]" w ocean.vert.
+class GerstnerWaves
+{
+public:
+    // domyslnie trzy fale, wczesniej wpisane na sztywno w shaderze
+    GerstnerWaves();
+
+    std::vector<GerstnerWave> waves;
+
+    // pobiera lokacje uniformow "waves[i].*" i "waveCount"
+    void bind(const Shader& shader);
+    // wysyla parametry; shader musi byc aktywny
+    void upload(const Shader& shader) const;
+
+private:
+    struct WaveHandles
+    {
+        UniformHandle direction;
+        UniformHandle steepness;
+        UniformHandle wavelength;
+        UniformHandle speed;
+    };
+    WaveHandles handles[MAX_GERSTNER_WAVES];
+    UniformHandle waveCountLoc;
+};
+
+#endif
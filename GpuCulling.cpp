@@ -0,0 +1,238 @@
+#include "GpuCulling.h"
+
+#include <iostream>
+#include <vector>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+//stale GL 4.3, ktorych nie ma w naglowku glad 3.3
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#endif
+#ifndef GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
+#define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x00000001
+#endif
+
+typedef void (APIENTRY* DispatchComputeFn)(GLuint x, GLuint y, GLuint z);
+typedef void (APIENTRY* MemoryBarrierFn)(GLbitfield barriers);
+typedef void (APIENTRY* DrawElementsIndirectFn)(GLenum mode, GLenum type, const void* indirect);
+typedef void (APIENTRY* DrawArraysIndirectFn)(GLenum mode, const void* indirect);
+
+static DispatchComputeFn dispatchCompute = nullptr;
+static MemoryBarrierFn memoryBarrier = nullptr;
+static DrawElementsIndirectFn drawElementsIndirect = nullptr;
+static DrawArraysIndirectFn drawArraysIndirect = nullptr;
+
+//DrawElementsIndirectCommand; DrawArraysIndirectCommand impostorow zajmuje 4 z nich
+static const int COMMAND_UINTS = 5;
+//komendy grupy: poziomy LOD i impostory (jak kubelki w scenery_cull.comp)
+static const int COMMAND_BUCKETS = MESH_MAX_LODS + 1;
+static const int IMPOSTOR_COMMAND = MESH_MAX_LODS;
+
+bool loadGpuCulling(GLADloadproc load)
+{
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major * 10 + minor < 43) {
+        std::cout << "INFO: GL " << major << "." << minor << " - culling GPU niedostepny, zostaje CPU" << std::endl;
+        return false;
+    }
+    dispatchCompute = (DispatchComputeFn)load("glDispatchCompute");
+    memoryBarrier = (MemoryBarrierFn)load("glMemoryBarrier");
+    drawElementsIndirect = (DrawElementsIndirectFn)load("glDrawElementsIndirect");
+    drawArraysIndirect = (DrawArraysIndirectFn)load("glDrawArraysIndirect");
+    if (!gpuCullingAvailable()) {
+        std::cerr << "ERROR: brak funkcji GL 4.3 mimo wersji kontekstu" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool gpuCullingAvailable()
+{
+    return dispatchCompute && memoryBarrier && drawElementsIndirect && drawArraysIndirect;
+}
+
+GpuInstanceSet::GpuInstanceSet(Shader& cullShader, int vec4PerInstance, int capacity, int maxGroups)
+    : cullShader(&cullShader), stride(vec4PerInstance), capacity(capacity), maxGroups(maxGroups)
+{
+    frustumPlanesLoc = cullShader.uniform("frustumPlanes");
+    strideLoc = cullShader.uniform("stride");
+    capacityLoc = cullShader.uniform("capacity");
+    impostorBaseLoc = cullShader.uniform("impostorBase");
+    cameraPositionLoc = cullShader.uniform("cameraPosition");
+    lodScaleLoc = cullShader.uniform("lodScale");
+    lodScreenSizeLoc = cullShader.uniform("lodScreenSize");
+    lodCountLoc = cullShader.uniform("lodCount");
+    firstLoc = cullShader.uniform("first");
+    countLoc = cullShader.uniform("count");
+    commandLoc = cullShader.uniform("command");
+    radiusLoc = cullShader.uniform("groupRadius");
+    impostorSizeLoc = cullShader.uniform("impostorScreenSize");
+    yawOffsetLoc = cullShader.uniform("yawOffset");
+    scaleLoc = cullShader.uniform("instanceScale");
+
+    GLsizeiptr instanceBytes = (GLsizeiptr)capacity * stride * sizeof(glm::vec4);
+
+    glGenBuffers(1, &sphereBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, sphereBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)capacity * sizeof(glm::vec4), NULL, GL_STATIC_DRAW);
+
+    glGenBuffers(1, &sourceBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, sourceBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, instanceBytes, NULL, GL_STATIC_DRAW);
+
+    //zapisywany i czytany tylko przez GPU; za zakresami LOD macierze impostorow
+    glGenBuffers(1, &visibleBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibleBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, instanceBytes * MESH_MAX_LODS + (GLsizeiptr)capacity * sizeof(glm::mat4),
+        NULL, GL_DYNAMIC_COPY);
+
+    glGenBuffers(1, &commandBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, maxGroups * COMMAND_BUCKETS * COMMAND_UINTS * sizeof(GLuint), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glGenBuffers(1, &templateBuffer);
+    glBindBuffer(GL_COPY_READ_BUFFER, templateBuffer);
+    glBufferData(GL_COPY_READ_BUFFER, maxGroups * COMMAND_BUCKETS * COMMAND_UINTS * sizeof(GLuint), NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
+
+void GpuInstanceSet::upload(const glm::vec4* instances, const glm::vec4* spheres, int count, bool dynamic)
+{
+    if (count > capacity) {
+        std::cerr << "ERROR: GpuInstanceSet - " << count << " instancji, pojemnosc " << capacity << std::endl;
+        count = capacity;
+    }
+    //pelny glBufferData odlacza stary bufor, wiec zapis nie czeka na poprzednia klatke
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, sourceBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)capacity * stride * sizeof(glm::vec4), NULL,
+        dynamic ? GL_STREAM_DRAW : GL_STATIC_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, (GLsizeiptr)count * stride * sizeof(glm::vec4), instances);
+    if (spheres) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, sphereBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, (GLsizeiptr)count * sizeof(glm::vec4), spheres);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuInstanceSet::cull(const Frustum& frustum, const glm::vec3& cameraPosition, float lodScale,
+    const GpuDrawGroup* groups, int groupCount, bool impostors)
+{
+    if (groupCount > maxGroups) groupCount = maxGroups;
+
+    //komendy z zerowa liczba instancji; baseInstance wskazuje zakres grupy w danym LOD
+    std::vector<GLuint>& commands = commandScratch;
+    commands.assign(groupCount * COMMAND_BUCKETS * COMMAND_UINTS, 0);
+    for (int g = 0; g < groupCount; ++g) {
+        const Mesh& mesh = *groups[g].mesh;
+        for (int l = 0; l < mesh.lodCount; ++l) {
+            GLuint* command = &commands[(g * COMMAND_BUCKETS + l) * COMMAND_UINTS];
+            command[0] = (GLuint)mesh.lods[l].indexCount;
+            command[2] = (GLuint)mesh.lods[l].firstIndex;
+            command[4] = (GLuint)(l * capacity + groups[g].first);
+        }
+        //DrawArraysIndirectCommand: count, instanceCount, first, baseInstance
+        GLuint* command = &commands[(g * COMMAND_BUCKETS + IMPOSTOR_COMMAND) * COMMAND_UINTS];
+        command[0] = 4;
+        command[3] = (GLuint)groups[g].first;
+    }
+    //zmieniaja sie tylko liczniki - szablon wysylany, gdy zmienia sie zakresy (np. liczby ryb gatunkow)
+    GLsizeiptr commandBytes = commands.size() * sizeof(GLuint);
+    glBindBuffer(GL_COPY_READ_BUFFER, templateBuffer);
+    if (commands != commandTemplate) {
+        glBufferSubData(GL_COPY_READ_BUFFER, 0, commandBytes, commands.data());
+        commandTemplate.swap(commands);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, commandBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, commandBytes);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, sphereBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, sourceBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, visibleBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, commandBuffer);
+
+    //program wspolny dla roslin i ryb - stale zestawu ustawiane przy kazdym cullingu
+    Shader& shader = *cullShader;
+    shader.Activate();
+    glUniform4fv(frustumPlanesLoc.location, 6, &frustum.planes[0][0]);
+    shader.setInt(strideLoc, stride);
+    shader.setInt(capacityLoc, capacity);
+    shader.setInt(impostorBaseLoc, MESH_MAX_LODS * capacity * stride);
+    shader.setVec3(cameraPositionLoc, cameraPosition);
+    shader.setFloat(lodScaleLoc, lodScale);
+    glUniform1fv(lodScreenSizeLoc.location, MESH_MAX_LODS, MESH_LOD_SCREEN_SIZE);
+    for (int g = 0; g < groupCount; ++g) {
+        if (groups[g].count == 0) continue;
+        shader.setInt(firstLoc, groups[g].first);
+        shader.setInt(countLoc, groups[g].count);
+        shader.setInt(commandLoc, g);
+        shader.setFloat(radiusLoc, groups[g].radius);
+        shader.setInt(lodCountLoc, groups[g].mesh->lodCount);
+        bool impostor = impostors && groups[g].impostor && groups[g].impostor->valid();
+        shader.setFloat(impostorSizeLoc, impostor ? IMPOSTOR_SCREEN_SIZE : 0.0f);
+        shader.setFloat(yawOffsetLoc, groups[g].yawOffset);
+        shader.setFloat(scaleLoc, groups[g].scale);
+        dispatchCompute((GLuint)(groups[g].count + 63) / 64, 1, 1);
+    }
+    //komendy i atrybuty instancji czytane dopiero po zapisach shadera
+    memoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void GpuInstanceSet::bindAttributes(const Mesh& mesh, int firstLocation) const
+{
+    glBindVertexArray(mesh.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, visibleBuffer);
+    GLsizei bytes = stride * sizeof(glm::vec4);
+    for (int c = 0; c < stride; ++c) {
+        glEnableVertexAttribArray(firstLocation + c);
+        glVertexAttribPointer(firstLocation + c, 4, GL_FLOAT, GL_FALSE, bytes, (void*)(c * sizeof(glm::vec4)));
+        glVertexAttribDivisor(firstLocation + c, 1);
+    }
+}
+
+void GpuInstanceSet::draw(const Mesh& mesh, int group) const
+{
+    glBindVertexArray(mesh.vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    for (int l = 0; l < mesh.lodCount; ++l) {
+        size_t command = (size_t)(group * COMMAND_BUCKETS + l) * COMMAND_UINTS * sizeof(GLuint);
+        drawElementsIndirect(GL_TRIANGLES, mesh.indexType, (const void*)command);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GpuInstanceSet::drawImpostors(const ImpostorAtlas& atlas, Shader& impostorShader, int group) const
+{
+    if (!atlas.valid()) return;
+
+    //baseInstance komendy wskazuje zakres grupy, atrybuty od poczatku macierzy impostorow
+    atlas.bind(impostorShader, visibleBuffer, (GLintptr)MESH_MAX_LODS * capacity * stride * sizeof(glm::vec4));
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    size_t command = (size_t)(group * COMMAND_BUCKETS + IMPOSTOR_COMMAND) * COMMAND_UINTS * sizeof(GLuint);
+    drawArraysIndirect(GL_TRIANGLE_STRIP, (const void*)command);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void GpuInstanceSet::Delete()
+{
+    GLuint buffers[5] = { sphereBuffer, sourceBuffer, visibleBuffer, commandBuffer, templateBuffer };
+    glDeleteBuffers(5, buffers);
+    sphereBuffer = sourceBuffer = visibleBuffer = commandBuffer = templateBuffer = 0;
+}
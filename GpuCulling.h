@@ -0,0 +1,80 @@
+#pragma once
+#ifndef GPU_CULLING_CLASS_H
+#define GPU_CULLING_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Frustum.h"
+#include "Impostor.h"
+#include "Mesh.h"
+#include "shaderClass.h"
+
+// Funkcje GL 4.3 (compute, bariery, rysowanie posrednie) spoza naszego
+// loadera 3.3. Zwraca false, gdy kontekst ich nie ma - wtedy zostaje
+// culling na CPU.
+bool loadGpuCulling(GLADloadproc load);
+bool gpuCullingAvailable();
+
+// Grupa instancji rysowana jedna komenda (typ rosliny, gatunek ryby).
+struct GpuDrawGroup
+{
+    const Mesh* mesh;
+    int first;
+    int count;
+    float radius;   // > 0: wspolny promien, sfera ze srodka instancji; 0: bufor sfer
+    const ImpostorAtlas* impostor = nullptr;    // dalekie instancje jako impostory
+    float yawOffset = 0.0f;     // stride 1: macierz impostora z (pozycja, yaw), jak fishModelMatrix
+    float scale = 1.0f;
+};
+
+// Instancje w SSBO na GPU: compute shader odrzuca niewidoczne, wybiera LOD,
+// kompaktuje reszte i sam wpisuje liczbe instancji do komend
+// DrawElementsIndirectCommand (jedna na grupe i poziom LOD) oraz
+// DrawArraysIndirectCommand czworokata impostorow. CPU wysyla
+// O(grupy * LOD) komend, niezaleznie od liczby instancji.
+class GpuInstanceSet
+{
+public:
+    GLuint sphereBuffer = 0;
+    GLuint sourceBuffer = 0;
+    GLuint visibleBuffer = 0;
+    GLuint commandBuffer = 0;
+
+    // cullShader: scenery_cull.comp, uniformy pobierane raz tutaj;
+    // vec4PerInstance: 4 dla macierzy model, 1 dla (pozycja, yaw); maxGroups komend
+    GpuInstanceSet(Shader& cullShader, int vec4PerInstance, int capacity, int maxGroups);
+
+    // dynamic: dane nadpisywane co klatke (ryby); spheres == nullptr gdy grupy maja wspolny promien
+    void upload(const glm::vec4* instances, const glm::vec4* spheres, int count, bool dynamic);
+    // lodScale: projection[1][1], jak w Mesh::selectLod; impostors: kubelek impostorow dla grup z atlasem
+    void cull(const Frustum& frustum, const glm::vec3& cameraPosition, float lodScale,
+        const GpuDrawGroup* groups, int groupCount, bool impostors);
+
+    // instancje z bufora widocznych pod lokacjami firstLocation.. (divisor 1)
+    void bindAttributes(const Mesh& mesh, int firstLocation) const;
+    void draw(const Mesh& mesh, int group) const;
+    // kubelek impostorow grupy - macierze model z bufora widocznych
+    void drawImpostors(const ImpostorAtlas& atlas, Shader& impostorShader, int group) const;
+
+    void Delete();
+
+private:
+    Shader* cullShader;
+    int stride;
+    int capacity;
+    int maxGroups;
+
+    //komendy z zerowymi licznikami; co klatke kopiowane na GPU do commandBuffer,
+    //wysylane z CPU tylko po zmianie zakresow grup
+    GLuint templateBuffer = 0;
+    std::vector<GLuint> commandTemplate;
+    std::vector<GLuint> commandScratch;
+
+    UniformHandle frustumPlanesLoc, strideLoc, capacityLoc, impostorBaseLoc, cameraPositionLoc, lodScaleLoc;
+    UniformHandle lodScreenSizeLoc, lodCountLoc, firstLoc, countLoc, commandLoc, radiusLoc;
+    UniformHandle impostorSizeLoc, yawOffsetLoc, scaleLoc;
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include "HeadlessContext.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#if defined(__linux__) && !defined(OCEANGL_NO_EGL)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+static void* eglLoad(const char* name)
+{
+    return (void*)eglGetProcAddress(name);
+}
+
+static bool hasExtension(const char* extensions, const char* name)
+{
+    if (!extensions) return false;
+    size_t length = strlen(name);
+    for (const char* p = strstr(extensions, name); p; p = strstr(p + length, name)) {
+        bool start = p == extensions || p[-1] == ' ';
+        bool end = p[length] == ' ' || p[length] == '\0';
+        if (start && end) return true;
+    }
+    return false;
+}
+
+//platforma surfaceless nie potrzebuje ani X11, ani urzadzenia DRM
+static EGLDisplay openDisplay()
+{
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay) {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+            if (display != EGL_NO_DISPLAY) return display;
+        }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+bool HeadlessContext::create()
+{
+    EGLDisplay eglDisplay = openDisplay();
+    EGLint major = 0, minor = 0;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        std::cerr << "ERROR: EGL - brak wyswietlacza" << std::endl;
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "ERROR: EGL - brak desktopowego OpenGL" << std::endl;
+        eglTerminate(eglDisplay);
+        return false;
+    }
+
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount) || configCount == 0) {
+        std::cerr << "ERROR: EGL - brak konfiguracji z OpenGL" << std::endl;
+        eglTerminate(eglDisplay);
+        return false;
+    }
+
+    //jak przy oknie GLFW: 4.3 dla cullingu na GPU, inaczej 3.3
+    EGLContext eglContext = EGL_NO_CONTEXT;
+    const EGLint versions[2][2] = { { 4, 3 }, { 3, 3 } };
+    for (const EGLint* version : versions) {
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, version[0],
+            EGL_CONTEXT_MINOR_VERSION, version[1],
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+        if (eglContext != EGL_NO_CONTEXT) break;
+    }
+    if (eglContext == EGL_NO_CONTEXT) {
+        std::cerr << "ERROR: EGL - nie mozna utworzyc kontekstu OpenGL 3.3" << std::endl;
+        eglTerminate(eglDisplay);
+        return false;
+    }
+
+    EGLSurface eglSurface = EGL_NO_SURFACE;
+    if (!hasExtension(eglQueryString(eglDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+        const EGLint pbufferAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        eglSurface = eglCreatePbufferSurface(eglDisplay, config, pbufferAttributes);
+    }
+    if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+        std::cerr << "ERROR: EGL - eglMakeCurrent nieudane" << std::endl;
+        if (eglSurface != EGL_NO_SURFACE) eglDestroySurface(eglDisplay, eglSurface);
+        eglDestroyContext(eglDisplay, eglContext);
+        eglTerminate(eglDisplay);
+        return false;
+    }
+
+    display = eglDisplay;
+    context = eglContext;
+    surface = eglSurface;
+    std::cout << "INFO: EGL " << major << "." << minor << " - kontekst bez okna" << std::endl;
+    return true;
+}
+
+GLADloadproc HeadlessContext::loader() const
+{
+    return eglLoad;
+}
+
+void HeadlessContext::Delete()
+{
+    if (!display) return;
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (surface) eglDestroySurface(display, surface);
+    if (context) eglDestroyContext(display, context);
+    eglTerminate(display);
+    display = context = surface = nullptr;
+}
+
+#else
+
+bool HeadlessContext::create()
+{
+    std::cerr << "ERROR: tryb bez okna wymaga EGL (Linux, bez OCEANGL_NO_EGL)" << std::endl;
+    return false;
+}
+
+GLADloadproc HeadlessContext::loader() const
+{
+    return nullptr;
+}
+
+void HeadlessContext::Delete()
+{
+}
+
+#endif
+
+void readFramebuffer(GLuint framebuffer, int width, int height, std::vector<unsigned char>& rgb)
+{
+    rgb.resize((size_t)width * height * 3);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    //GL zwraca wiersze od dolu
+    size_t row = (size_t)width * 3;
+    std::vector<unsigned char> swap(row);
+    for (int y = 0; y < height / 2; ++y) {
+        unsigned char* top = &rgb[y * row];
+        unsigned char* bottom = &rgb[(height - 1 - y) * row];
+        memcpy(swap.data(), top, row);
+        memcpy(top, bottom, row);
+        memcpy(bottom, swap.data(), row);
+    }
+}
+
+bool writePPM(const std::string& path, int width, int height, const std::vector<unsigned char>& rgb)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "ERROR: nie mozna zapisac " << path << std::endl;
+        return false;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    size_t written = fwrite(rgb.data(), 1, rgb.size(), file);
+    fclose(file);
+    return written == rgb.size();
+}
@@ -0,0 +1,38 @@
+#pragma once
+#ifndef HEADLESS_CONTEXT_CLASS_H
+#define HEADLESS_CONTEXT_CLASS_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+// Kontekst GL bez okna i bez serwera wyswietlania (EGL surfaceless, np. Mesa
+// llvmpipe na serwerze bez GPU). Scena i tak rysuje do wlasnych FBO, wiec
+// kontekst nie ma domyslnego bufora ramki. Tylko Linux; przy kompilacji
+// z OCEANGL_NO_EGL (albo poza Linuxem) create() zawsze zwraca false.
+class HeadlessContext
+{
+public:
+    // najpierw GL 4.3 core, bez niego 3.3 core
+    bool create();
+    bool valid() const { return context != nullptr; }
+
+    // loader dla gladLoadGLLoader / loadGpuCulling
+    GLADloadproc loader() const;
+
+    void Delete();
+
+private:
+    void* display = nullptr;
+    void* context = nullptr;
+    void* surface = nullptr;    // pbuffer 1x1, gdy brak EGL_KHR_surfaceless_context
+};
+
+// Odczyt koloru (RGB, wiersze od gory) z przypietego FBO
+void readFramebuffer(GLuint framebuffer, int width, int height, std::vector<unsigned char>& rgb);
+
+// Zapis klatki jako binarny PPM (P6)
+bool writePPM(const std::string& path, int width, int height, const std::vector<unsigned char>& rgb);
+
+#endif
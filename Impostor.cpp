@@ -0,0 +1,172 @@
+#include "Impostor.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <iostream>
+
+static float signNotZero(float v)
+{
+    return v >= 0.0f ? 1.0f : -1.0f;
+}
+
+glm::vec2 octahedralEncode(const glm::vec3& direction)
+{
+    glm::vec3 n = direction / (std::fabs(direction.x) + std::fabs(direction.y) + std::fabs(direction.z));
+    glm::vec2 p(n.x, n.z);
+    //dolna polkula zawinieta na rogi kwadratu
+    if (n.y < 0.0f)
+        p = glm::vec2((1.0f - std::fabs(p.y)) * signNotZero(p.x), (1.0f - std::fabs(p.x)) * signNotZero(p.y));
+    return p * 0.5f + glm::vec2(0.5f);
+}
+
+glm::vec3 octahedralDecode(const glm::vec2& uv)
+{
+    glm::vec2 p = uv * 2.0f - glm::vec2(1.0f);
+    glm::vec3 n(p.x, 1.0f - std::fabs(p.x) - std::fabs(p.y), p.y);
+    if (n.y < 0.0f) {
+        float x = (1.0f - std::fabs(n.z)) * signNotZero(n.x);
+        float z = (1.0f - std::fabs(n.x)) * signNotZero(n.z);
+        n.x = x;
+        n.z = z;
+    }
+    return glm::normalize(n);
+}
+
+bool ImpostorAtlas::bake(Shader& bakeShader, const Mesh& mesh, GLuint texture, const glm::vec3& baseColor,
+    const glm::vec2& uvScale, const glm::vec2& uvOffset)
+{
+    Delete();
+    boundsCenter = mesh.boundsCenter;
+    boundsRadius = mesh.boundsRadius;
+    if (mesh.vao == 0 || boundsRadius <= 0.0f) return false;
+
+    const int size = IMPOSTOR_FRAMES * IMPOSTOR_FRAME_SIZE;
+    GLuint textures[2];
+    glGenTextures(2, textures);
+    for (GLuint tex : textures) {
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    albedoTexture = textures[0];
+    normalTexture = textures[1];
+
+    GLuint fbo = 0, depth = 0;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedoTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normalTexture, 0);
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size, size);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+    GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, drawBuffers);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    if (complete) {
+        glDisable(GL_BLEND);
+        glEnable(GL_DEPTH_TEST);
+        glViewport(0, 0, size, size);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        bakeShader.Activate();
+        bakeShader.setVec3("baseColor", baseColor);
+        bakeShader.setBool("useTexture", texture != 0);
+        bakeShader.setInt("texture_diffuse1", 0);
+        bakeShader.setVec2("uvScale", uvScale);
+        bakeShader.setVec2("uvOffset", uvOffset);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        UniformHandle viewProjectionLoc = bakeShader.uniform("viewProjection");
+
+        //kazde ujecie: rzut ortogonalny sfery otaczajacej z kierunku srodka komorki
+        float r = boundsRadius;
+        glm::mat4 projection = glm::ortho(-r, r, -r, r, 0.0f, 2.0f * r);
+        for (int j = 0; j < IMPOSTOR_FRAMES; ++j) {
+            for (int i = 0; i < IMPOSTOR_FRAMES; ++i) {
+                glm::vec3 d = octahedralDecode((glm::vec2((float)i, (float)j) + glm::vec2(0.5f)) / (float)IMPOSTOR_FRAMES);
+                glm::vec3 up = std::fabs(d.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+                glm::mat4 view = glm::lookAt(boundsCenter + d * r, boundsCenter, up);
+                glViewport(i * IMPOSTOR_FRAME_SIZE, j * IMPOSTOR_FRAME_SIZE, IMPOSTOR_FRAME_SIZE, IMPOSTOR_FRAME_SIZE);
+                bakeShader.setMat4(viewProjectionLoc, projection * view);
+                mesh.draw();
+            }
+        }
+        glBindVertexArray(0);
+    }
+    else {
+        std::cerr << "ERROR: Impostor - niekompletny framebuffer" << std::endl;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (blend) glEnable(GL_BLEND);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &depth);
+    if (!complete) {
+        Delete();
+        return false;
+    }
+
+    //czworokat (-1..1), rozpinany w impostor.vert na plaszczyznie ujecia
+    const float corners[8] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+    glGenVertexArrays(1, &quadVAO);
+    glGenBuffers(1, &quadVBO);
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glBindVertexArray(0);
+    return true;
+}
+
+void ImpostorAtlas::draw(Shader& impostorShader, GLuint instanceBuffer, GLintptr offset, int count) const
+{
+    if (!valid() || count == 0) return;
+
+    bind(impostorShader, instanceBuffer, offset);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+    glBindVertexArray(0);
+}
+
+void ImpostorAtlas::bind(Shader& impostorShader, GLuint instanceBuffer, GLintptr offset) const
+{
+    impostorShader.Activate();
+    impostorShader.setVec3("boundsCenter", boundsCenter);
+    impostorShader.setFloat("boundsRadius", boundsRadius);
+    impostorShader.setInt("impostorFrames", IMPOSTOR_FRAMES);
+    //jednostki 3 i 4 - 0..2 zajmuja skybox i tekstury oceanu FFT
+    impostorShader.setInt("impostorAlbedo", 3);
+    impostorShader.setInt("impostorNormal", 4);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, albedoTexture);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, normalTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    for (int c = 0; c < 4; ++c) {
+        glEnableVertexAttribArray(3 + c);
+        glVertexAttribPointer(3 + c, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(offset + c * sizeof(glm::vec4)));
+        glVertexAttribDivisor(3 + c, 1);
+    }
+}
+
+void ImpostorAtlas::Delete()
+{
+    if (albedoTexture) glDeleteTextures(1, &albedoTexture);
+    if (normalTexture) glDeleteTextures(1, &normalTexture);
+    if (quadVAO) glDeleteVertexArrays(1, &quadVAO);
+    if (quadVBO) glDeleteBuffers(1, &quadVBO);
+    albedoTexture = normalTexture = quadVAO = quadVBO = 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#ifndef IMPOSTOR_CLASS_H
+#define IMPOSTOR_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Mesh.h"
+#include "shaderClass.h"
+
+// Siatka N x N ujec w atlasie, kazde ujecie ma bok IMPOSTOR_FRAME_SIZE pikseli
+const int IMPOSTOR_FRAMES = 8;
+const int IMPOSTOR_FRAME_SIZE = 64;
+// ponizej tego rozmiaru na ekranie (jak w Mesh::selectLod) instancja jest rysowana jako impostor
+const float IMPOSTOR_SCREEN_SIZE = 0.015f;
+
+// Kierunek <-> wspolrzedne w mapowaniu oktaedrycznym calej sfery (os Y w srodku
+// atlasu). Te same wzory sa w impostor.vert.
+glm::vec2 octahedralEncode(const glm::vec3& direction);
+glm::vec3 octahedralDecode(const glm::vec2& uv);
+
+// Oktaedryczny impostor siatki: przy ladowaniu siatka jest renderowana
+// ortograficznie z IMPOSTOR_FRAMES^2 kierunkow do atlasu koloru i normalnych
+// (uklad modelu). Daleka instancja to jeden czworokat zwrocony w strone
+// najblizszego ujecia, oswietlany jak zwykla siatka.
+class ImpostorAtlas
+{
+public:
+    GLuint albedoTexture = 0;   // rgb = kolor bazowy, a = pokrycie
+    GLuint normalTexture = 0;   // rgb = normalna modelu * 0.5 + 0.5
+
+    // texture == 0: jednolity baseColor (rosliny); uvScale/uvOffset jak w fish.vert
+    bool bake(Shader& bakeShader, const Mesh& mesh, GLuint texture, const glm::vec3& baseColor,
+        const glm::vec2& uvScale = glm::vec2(1.0f), const glm::vec2& uvOffset = glm::vec2(0.0f));
+    bool valid() const { return albedoTexture != 0; }
+
+    // count instancji z macierzami model (lokacje 3..6) od offsetu w instanceBuffer
+    void draw(Shader& impostorShader, GLuint instanceBuffer, GLintptr offset, int count) const;
+    // shader, atlas i VAO czworokata z instancjami od offsetu - dla rysowania posredniego
+    // (trojkatny pas 4 wierzcholkow, VAO zostaje zwiazane)
+    void bind(Shader& impostorShader, GLuint instanceBuffer, GLintptr offset) const;
+
+    void Delete();
+
+private:
+    GLuint quadVAO = 0;
+    GLuint quadVBO = 0;
+    glm::vec3 boundsCenter = glm::vec3(0.0f);
+    float boundsRadius = 0.0f;
+};
+
+#endif
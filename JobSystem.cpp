@@ -0,0 +1,208 @@
+#include "JobSystem.h"
+#include "Trace.h"
+
+#include <string>
+
+//kolejka biezacego watku w danym JobSystem (-1: brak)
+thread_local const JobSystem* tlsJobSystem = nullptr;
+thread_local int tlsDequeIndex = -1;
+
+JobSystem::JobSystem(int workerCount)
+{
+    if (workerCount <= 0)
+    {
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = cores > 1 ? cores - 1 : 1;
+    }
+    for (int i = 0; i <= workerCount; ++i)
+        deques.push_back(new WorkStealingDeque<Job>());
+
+    tlsJobSystem = this;
+    tlsDequeIndex = 0;
+
+    workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i)
+        workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping.store(true);
+    }
+    wakeUp.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+
+    //niewykonane zadania (np. z kolejki wspolnej) tylko zwalniamy
+    for (WorkStealingDeque<Job>* deque : deques) {
+        while (Job* job = deque->steal()) delete job;
+        delete deque;
+    }
+    for (Job* job : injected) delete job;
+    if (tlsJobSystem == this) { tlsJobSystem = nullptr; tlsDequeIndex = -1; }
+}
+
+void JobSystem::push(Job* job)
+{
+    bool pushed = false;
+    if (tlsJobSystem == this && tlsDequeIndex >= 0)
+        pushed = deques[tlsDequeIndex]->push(job);
+    if (!pushed)
+    {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        injected.push_back(job);
+        haveInjected.store(true, std::memory_order_release);
+    }
+
+    //epoka zmieniona przed sprawdzeniem spiacych - zasypiajacy watek to zauwazy
+    wakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_seq_cst) > 0)
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wakeUp.notify_one();
+    }
+}
+
+void JobSystem::submit(std::function<void()> job, JobCounter* counter)
+{
+    if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+    push(new Job{ std::move(job), counter });
+}
+
+void JobSystem::submitAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter)
+{
+    if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(dependency.continuationMutex);
+        if (!dependency.done())
+        {
+            dependency.continuations.emplace_back(std::move(job), counter);
+            return;
+        }
+    }
+    push(new Job{ std::move(job), counter });
+}
+
+void JobSystem::complete(JobCounter* counter)
+{
+    //nie ostatnie zadanie - samo zmniejszenie, potem licznika juz nie dotykamy
+    int pending = counter->pending.load(std::memory_order_relaxed);
+    while (pending > 1)
+    {
+        if (counter->pending.compare_exchange_weak(pending, pending - 1,
+            std::memory_order_acq_rel, std::memory_order_relaxed))
+            return;
+    }
+
+    //zejscie do zera i zabranie kontynuacji pod mutexem; wait() bierze ten sam
+    //mutex po zobaczeniu zera, wiec licznik na stosie nie zniknie przed unlock
+    std::vector<std::pair<std::function<void()>, JobCounter*>> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter->continuationMutex);
+        if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            ready.swap(counter->continuations);
+    }
+    for (auto& continuation : ready)
+        push(new Job{ std::move(continuation.first), continuation.second });
+}
+
+void JobSystem::execute(Job* job)
+{
+    {
+        TraceScope trace("job", "jobs");
+        job->fn();
+    }
+    JobCounter* counter = job->counter;
+    delete job;
+    if (counter) complete(counter);
+}
+
+JobSystem::Job* JobSystem::find(int self)
+{
+    if (self >= 0)
+    {
+        if (Job* job = deques[self]->pop()) return job;
+    }
+    if (haveInjected.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        if (!injected.empty())
+        {
+            Job* job = injected.front();
+            injected.pop_front();
+            if (injected.empty()) haveInjected.store(false, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    //kradziez - start od sasiada, zeby watki nie tloczyly sie na jednej kolejce
+    int count = static_cast<int>(deques.size());
+    int start = self >= 0 ? self + 1 : 0;
+    for (int i = 0; i < count; ++i)
+    {
+        int victim = (start + i) % count;
+        if (victim == self) continue;
+        if (Job* job = deques[victim]->steal()) return job;
+    }
+    return nullptr;
+}
+
+bool JobSystem::runOne()
+{
+    int self = (tlsJobSystem == this) ? tlsDequeIndex : -1;
+    Job* job = find(self);
+    if (!job) return false;
+    execute(job);
+    return true;
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+    while (!counter.done())
+    {
+        if (!runOne()) std::this_thread::yield();
+    }
+    //ostatni complete() moze jeszcze trzymac mutex - po nim licznik wolno zniszczyc
+    std::lock_guard<std::mutex> lock(counter.continuationMutex);
+}
+
+void JobSystem::parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& fn)
+{
+    if (end <= begin) return;
+    if (grain < 1) grain = 1;
+    JobCounter counter;
+    //ostatnia paczka na biezacym watku - jedno zadanie mniej
+    int lastBegin = begin + ((end - begin - 1) / grain) * grain;
+    for (int b = begin; b < lastBegin; b += grain)
+    {
+        int e = b + grain;
+        submit([&fn, b, e] { fn(b, e); }, &counter);
+    }
+    fn(lastBegin, end);
+    wait(counter);
+}
+
+void JobSystem::workerLoop(int index)
+{
+    tlsJobSystem = this;
+    tlsDequeIndex = index;
+    traceThreadName("worker " + std::to_string(index));
+
+    for (;;)
+    {
+        unsigned int epoch = wakeEpoch.load(std::memory_order_seq_cst);
+        if (Job* job = find(index))
+        {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (stopping.load()) return;
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        wakeUp.wait(lock, [&] { return stopping.load() || wakeEpoch.load(std::memory_order_seq_cst) != epoch; });
+        sleepers.fetch_sub(1, std::memory_order_seq_cst);
+        if (stopping.load()) return;
+    }
+}
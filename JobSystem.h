@@ -0,0 +1,159 @@
+#pragma once
+#ifndef JOB_SYSTEM_CLASS_H
+#define JOB_SYSTEM_CLASS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class JobSystem;
+
+// Licznik niezakonczonych zadan; wait() czeka az spadnie do zera.
+// Zadania z JobSystem::submitAfter startuja, gdy licznik osiagnie zero.
+// Licznik wolno zniszczyc dopiero po wait(), nie po samym done().
+struct JobCounter
+{
+    std::atomic<int> pending{ 0 };
+
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::mutex continuationMutex;
+    std::vector<std::pair<std::function<void()>, JobCounter*>> continuations;
+};
+
+// Kolejka Chase-Lev jednego watku: wlasciciel wklada i zdejmuje z dolu
+// (LIFO, cieple cache), pozostali kradna z gory. Staly rozmiar - przy
+// przepelnieniu push() zwraca false i zadanie trafia do kolejki wspolnej.
+template <typename T>
+class WorkStealingDeque
+{
+public:
+    explicit WorkStealingDeque(int capacity = 4096)
+        : mask(capacity - 1), buffer(new std::atomic<T*>[capacity]) {}
+    ~WorkStealingDeque() { delete[] buffer; }
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // tylko wlasciciel
+    bool push(T* item)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t > mask) return false;
+        buffer[b & mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // tylko wlasciciel
+    T* pop()
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T* item = buffer[b & mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            //ostatni element - wyscig ze zlodziejem
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // dowolny watek
+    T* steal()
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        T* item = buffer[t & mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return item;
+    }
+
+    bool empty() const
+    {
+        return top.load(std::memory_order_acquire) >= bottom.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> top{ 0 };
+    alignas(64) std::atomic<int64_t> bottom{ 0 };
+    const int64_t mask;
+    std::atomic<T*>* buffer;
+};
+
+// Pula watkow z kradzieza pracy. Kazdy watek roboczy oraz watek, ktory
+// utworzyl JobSystem, ma wlasna kolejke; pozostale watki wrzucaja zadania
+// do kolejki wspolnej. Bezczynne watki kradna od innych, a gdy nic nie ma -
+// zasypiaja do nastepnego submit().
+class JobSystem
+{
+public:
+    // workerCount <= 0: liczba rdzeni - 1 (watek glowny tez pomaga w wait())
+    explicit JobSystem(int workerCount = 0);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void submit(std::function<void()> job, JobCounter* counter = nullptr);
+    // zadanie zalezne: startuje, gdy dependency spadnie do zera
+    void submitAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter = nullptr);
+
+    // dzieli [begin, end) na paczki po grain i czeka na wszystkie;
+    // fn(b, e) dostaje zakres [b, e)
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& fn);
+
+    // wykonuje zadania na biezacym watku, dopoki licznik nie spadnie do zera
+    void wait(JobCounter& counter);
+
+    // wykonuje co najwyzej jedno zadanie; false, gdy nic nie znaleziono
+    bool runOne();
+
+    int workerCount() const { return static_cast<int>(workers.size()); }
+
+private:
+    struct Job
+    {
+        std::function<void()> fn;
+        JobCounter* counter;
+    };
+
+    std::vector<std::thread> workers;
+    // [0] - watek tworzacy, [1..] - watki robocze
+    std::vector<WorkStealingDeque<Job>*> deques;
+    std::deque<Job*> injected;
+    std::mutex injectedMutex;
+    std::atomic<bool> haveInjected{ false };
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<unsigned int> wakeEpoch{ 0 };
+    std::atomic<int> sleepers{ 0 };
+    std::atomic<bool> stopping{ false };
+
+    void push(Job* job);
+    Job* find(int self);
+    void workerLoop(int index);
+    void execute(Job* job);
+    void complete(JobCounter* counter);
+};
+
+#endif
@@ -0,0 +1,254 @@
+#include "Mesh.h"
+#include "MeshCache.h"
+#include "MeshSimplify.h"
+#include "Trace.h"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+#include <iostream>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // wierzcholek OBJ jest jednoznacznie wyznaczony przez trojke indeksow v/vt/vn
+    struct ObjIndexKey
+    {
+        int vertex, normal, texcoord;
+
+        bool operator==(const ObjIndexKey& o) const
+        {
+            return vertex == o.vertex && normal == o.normal && texcoord == o.texcoord;
+        }
+    };
+
+    struct ObjIndexKeyHash
+    {
+        size_t operator()(const ObjIndexKey& k) const
+        {
+            size_t h = std::hash<int>()(k.vertex);
+            h ^= std::hash<int>()(k.normal) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<int>()(k.texcoord) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+}
+
+bool parseObj(const char* path, MeshData& out)
+{
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path)) {
+        std::cerr << "TINYOBJLOADER_ERROR: " << warn << err << std::endl;
+        return false;
+    }
+
+    out.vertices.clear();
+    out.indices.clear();
+
+    std::unordered_map<ObjIndexKey, unsigned int, ObjIndexKeyHash> unique;
+
+    for (const auto& shape : shapes) {
+        for (const auto& index : shape.mesh.indices) {
+            // brak normalnych/uv w pliku -> te same wartosci domyslne dla calego wierzcholka
+            bool hasNormal = index.normal_index >= 0 && !attrib.normals.empty();
+            bool hasTexcoord = index.texcoord_index >= 0 && !attrib.texcoords.empty();
+            ObjIndexKey key = { index.vertex_index, hasNormal ? index.normal_index : -1, hasTexcoord ? index.texcoord_index : -1 };
+
+            auto it = unique.find(key);
+            if (it != unique.end()) {
+                out.indices.push_back(it->second);
+                continue;
+            }
+
+            unsigned int newIndex = static_cast<unsigned int>(out.vertices.size() / MESH_VERTEX_FLOATS);
+            unique.emplace(key, newIndex);
+            out.indices.push_back(newIndex);
+
+            out.vertices.push_back(attrib.vertices[3 * index.vertex_index + 0]);
+            out.vertices.push_back(attrib.vertices[3 * index.vertex_index + 1]);
+            out.vertices.push_back(attrib.vertices[3 * index.vertex_index + 2]);
+
+            if (hasNormal) {
+                out.vertices.push_back(attrib.normals[3 * index.normal_index + 0]);
+                out.vertices.push_back(attrib.normals[3 * index.normal_index + 1]);
+                out.vertices.push_back(attrib.normals[3 * index.normal_index + 2]);
+            }
+            else { out.vertices.push_back(0.0f); out.vertices.push_back(1.0f); out.vertices.push_back(0.0f); }
+
+            if (hasTexcoord) {
+                out.vertices.push_back(attrib.texcoords[2 * index.texcoord_index + 0]);
+                out.vertices.push_back(1.0f - attrib.texcoords[2 * index.texcoord_index + 1]);
+            }
+            else { out.vertices.push_back(0.0f); out.vertices.push_back(0.0f); }
+        }
+    }
+    return !out.indices.empty();
+}
+
+GLenum meshIndexType(int vertexCount)
+{
+    return vertexCount <= 0xFFFF ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+std::vector<unsigned char> packIndices(const std::vector<unsigned int>& indices, GLenum indexType)
+{
+    std::vector<unsigned char> packed;
+    if (indexType == GL_UNSIGNED_SHORT) {
+        packed.resize(indices.size() * sizeof(uint16_t));
+        uint16_t* out = reinterpret_cast<uint16_t*>(packed.data());
+        for (size_t i = 0; i < indices.size(); ++i) out[i] = static_cast<uint16_t>(indices[i]);
+    }
+    else {
+        packed.resize(indices.size() * sizeof(unsigned int));
+        if (!indices.empty()) std::memcpy(packed.data(), indices.data(), packed.size());
+    }
+    return packed;
+}
+
+void uploadMesh(const MeshData& data, Mesh& mesh)
+{
+    int vertexCount = static_cast<int>(data.vertices.size() / MESH_VERTEX_FLOATS);
+    GLenum indexType = meshIndexType(vertexCount);
+    std::vector<unsigned char> packed = packIndices(data.indices, indexType);
+    uploadMesh(data.vertices.data(), vertexCount, packed.data(), static_cast<int>(data.indices.size()), indexType, mesh,
+        data.lods.data(), static_cast<int>(data.lods.size()));
+}
+
+void computeMeshBounds(const float* vertices, int vertexCount, glm::vec3& center, float& radius)
+{
+    center = glm::vec3(0.0f);
+    radius = 0.0f;
+    if (vertexCount == 0) return;
+
+    glm::vec3 lo(vertices[0], vertices[1], vertices[2]);
+    glm::vec3 hi = lo;
+    for (int i = 1; i < vertexCount; ++i) {
+        const float* v = vertices + (size_t)i * MESH_VERTEX_FLOATS;
+        lo = glm::min(lo, glm::vec3(v[0], v[1], v[2]));
+        hi = glm::max(hi, glm::vec3(v[0], v[1], v[2]));
+    }
+    center = (lo + hi) * 0.5f;
+    float radius2 = 0.0f;
+    for (int i = 0; i < vertexCount; ++i) {
+        const float* v = vertices + (size_t)i * MESH_VERTEX_FLOATS;
+        glm::vec3 d = glm::vec3(v[0], v[1], v[2]) - center;
+        radius2 = std::max(radius2, glm::dot(d, d));
+    }
+    radius = std::sqrt(radius2);
+}
+
+void uploadMesh(const float* vertices, int vertexCount, const void* indices, int indexCount, GLenum indexType, Mesh& mesh,
+    const MeshLod* lods, int lodCount)
+{
+    //liczone z wierzcholkow przy kazdym uploadzie - takze dla siatek z cache
+    computeMeshBounds(vertices, vertexCount, mesh.boundsCenter, mesh.boundsRadius);
+
+    if (!lods || lodCount <= 0) {
+        mesh.lods[0] = { 0, indexCount };
+        mesh.lodCount = 1;
+    }
+    else {
+        mesh.lodCount = std::min(lodCount, MESH_MAX_LODS);
+        for (int l = 0; l < mesh.lodCount; ++l) mesh.lods[l] = lods[l];
+    }
+    mesh.vertexCount = vertexCount;
+    mesh.indexCount = mesh.lods[0].indexCount;
+    mesh.indexType = indexType;
+
+    glGenVertexArrays(1, &mesh.vao);
+    glGenBuffers(1, &mesh.vbo);
+    glGenBuffers(1, &mesh.ebo);
+    glBindVertexArray(mesh.vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertexCount * MESH_VERTEX_FLOATS * sizeof(float), vertices, GL_STATIC_DRAW);
+
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indexCount * indexSize), indices, GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, MESH_VERTEX_FLOATS * sizeof(float), (void*)0); glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, MESH_VERTEX_FLOATS * sizeof(float), (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, MESH_VERTEX_FLOATS * sizeof(float), (void*)(6 * sizeof(float))); glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+}
+
+void logMeshLoad(const char* path, const Mesh& mesh, const MeshData* parsed, double milliseconds)
+{
+    if (!parsed) {
+        std::cout << "INFO: Model loaded from cache: " << path << ", Vertices: " << mesh.vertexCount
+            << ", Indices: " << mesh.indexCount << ", " << milliseconds << " ms" << std::endl;
+        return;
+    }
+
+    // porownanie z dawnym formatem (8 floatow na kazdy indeks, bez EBO)
+    size_t flatBytes = parsed->indices.size() * MESH_VERTEX_FLOATS * sizeof(float);
+    size_t indexBytes = parsed->indices.size() * (mesh.indexType == GL_UNSIGNED_SHORT ? 2 : 4);
+    size_t indexedBytes = parsed->vertices.size() * sizeof(float) + indexBytes;
+    std::cout << "INFO: Model loaded: " << path
+        << ", Vertices: " << mesh.vertexCount << " (flat: " << mesh.indexCount << ")"
+        << ", Indices: " << mesh.indexCount << (mesh.indexType == GL_UNSIGNED_SHORT ? " (16-bit)" : " (32-bit)")
+        << ", Memory: " << flatBytes / 1024 << " KB -> " << indexedBytes / 1024 << " KB"
+        << ", LOD:";
+    for (int l = 0; l < mesh.lodCount; ++l)
+        std::cout << (l ? "/" : " ") << mesh.lods[l].indexCount / 3;
+    std::cout << " tri, " << milliseconds << " ms" << std::endl;
+}
+
+bool loadObj(const char* path, Mesh& mesh)
+{
+    TraceScope trace("loadObj", "assets", path);
+    auto start = std::chrono::steady_clock::now();
+
+    if (loadMeshCache(path, mesh)) {
+        logMeshLoad(path, mesh, nullptr, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        return true;
+    }
+
+    MeshData data;
+    if (!parseObj(path, data)) return false;
+    generateMeshLods(data);
+    uploadMesh(data, mesh);
+    storeMeshCache(path, data);
+
+    logMeshLoad(path, mesh, &data, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    return true;
+}
+
+int Mesh::selectLod(float screenSize) const
+{
+    int lod = 0;
+    while (lod + 1 < lodCount && screenSize < MESH_LOD_SCREEN_SIZE[lod + 1]) lod++;
+    return lod;
+}
+
+void Mesh::draw(int lod) const
+{
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    glBindVertexArray(vao);
+    glDrawElements(GL_TRIANGLES, lods[lod].indexCount, indexType, (void*)(lods[lod].firstIndex * indexSize));
+}
+
+void Mesh::drawInstanced(int instanceCount, int lod) const
+{
+    size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    glBindVertexArray(vao);
+    glDrawElementsInstanced(GL_TRIANGLES, lods[lod].indexCount, indexType, (void*)(lods[lod].firstIndex * indexSize), instanceCount);
+}
+
+void Mesh::Delete()
+{
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ebo);
+    vao = vbo = ebo = 0;
+}
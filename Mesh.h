@@ -0,0 +1,71 @@
+#pragma once
+#ifndef MESH_CLASS_H
+#define MESH_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+// Uklad wierzcholka: pozycja (3), normalna (3), uv (2)
+const int MESH_VERTEX_FLOATS = 8;
+
+// Poziomy szczegolowosci: LOD 0 to pelna siatka, kolejne to zakresy tego
+// samego bufora indeksow (wspolne wierzcholki).
+const int MESH_MAX_LODS = 4;
+// rozmiar sfery na ekranie (promien / pol wysokosci ekranu), ponizej ktorego uzywamy poziomu l
+const float MESH_LOD_SCREEN_SIZE[MESH_MAX_LODS] = { 0.0f, 0.08f, 0.03f, 0.012f };
+
+struct MeshLod
+{
+    int firstIndex;
+    int indexCount;
+};
+
+// Siatka po stronie CPU: unikalne wierzcholki + indeksy trojkatow.
+struct MeshData
+{
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<MeshLod> lods;      // puste: jeden poziom ze wszystkich indeksow
+};
+
+// Siatka na GPU. Indeksy 16-bitowe, jesli liczba wierzcholkow sie miesci.
+struct Mesh
+{
+    unsigned int vao = 0;
+    unsigned int vbo = 0;
+    unsigned int ebo = 0;
+    int vertexCount = 0;
+    int indexCount = 0;             // LOD 0
+    GLenum indexType = GL_UNSIGNED_INT;
+    MeshLod lods[MESH_MAX_LODS] = {};
+    int lodCount = 1;
+    //sfera otaczajaca w ukladzie modelu (srodek AABB), do cullingu
+    glm::vec3 boundsCenter = glm::vec3(0.0f);
+    float boundsRadius = 0.0f;
+
+    // screenSize: promien sfery * projection[1][1] / odleglosc
+    int selectLod(float screenSize) const;
+
+    void draw(int lod = 0) const;
+    void drawInstanced(int instanceCount, int lod = 0) const;
+    void Delete();
+};
+
+// 16-bit indeksy, jesli wszystkie wierzcholki sie mieszcza
+GLenum meshIndexType(int vertexCount);
+std::vector<unsigned char> packIndices(const std::vector<unsigned int>& indices, GLenum indexType);
+
+bool parseObj(const char* path, MeshData& out);
+// sfera otaczajaca wierzcholki (uklad MESH_VERTEX_FLOATS)
+void computeMeshBounds(const float* vertices, int vertexCount, glm::vec3& center, float& radius);
+void uploadMesh(const MeshData& data, Mesh& mesh);
+// indexCount: wszystkie indeksy w buforze; lods == nullptr: jeden poziom
+void uploadMesh(const float* vertices, int vertexCount, const void* indices, int indexCount, GLenum indexType, Mesh& mesh,
+    const MeshLod* lods = nullptr, int lodCount = 0);
+// korzysta z binarnego cache (MeshCache), a przy jego braku parsuje OBJ i zapisuje cache
+bool loadObj(const char* path, Mesh& mesh);
+// parsed == nullptr: siatka z cache
+void logMeshLoad(const char* path, const Mesh& mesh, const MeshData* parsed, double milliseconds);
+
+#endif
@@ -0,0 +1,217 @@
+#include "MeshCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static MeshCacheStats cacheStats;
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const char* path)
+{
+    close();
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) { CloseHandle(file); return false; }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) { CloseHandle(file); return false; }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mapping); CloseHandle(file); return false; }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    bytes = static_cast<const unsigned char*>(view);
+    length = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    bytes = nullptr; length = 0;
+    fileHandle = mappingHandle = nullptr;
+}
+#else
+bool MappedFile::open(const char* path)
+{
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+
+    bytes = static_cast<const unsigned char*>(view);
+    length = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (bytes) munmap(const_cast<unsigned char*>(bytes), length);
+    bytes = nullptr; length = 0;
+}
+#endif
+
+// FNV-1a ze sciezki zrodla -> nazwa pliku w katalogu cache
+static std::string cachePathFor(const char* sourcePath)
+{
+    uint64_t hash = 1469598103934665603ull;
+    for (const char* c = sourcePath; *c; ++c) {
+        hash ^= static_cast<unsigned char>(*c);
+        hash *= 1099511628211ull;
+    }
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.mesh", static_cast<unsigned long long>(hash));
+    return (fs::path(MESH_CACHE_DIR) / name).string();
+}
+
+static bool sourceStamp(const char* sourcePath, uint64_t& size, int64_t& mtime)
+{
+    std::error_code ec;
+    size = static_cast<uint64_t>(fs::file_size(sourcePath, ec));
+    if (ec) return false;
+    auto time = fs::last_write_time(sourcePath, ec);
+    if (ec) return false;
+    mtime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+bool openMeshCache(const char* sourcePath, MeshCacheView& view)
+{
+    uint64_t size = 0; int64_t mtime = 0;
+    if (!sourceStamp(sourcePath, size, mtime)) { cacheStats.misses++; return false; }
+
+    MappedFile& file = view.file;
+    if (!file.open(cachePathFor(sourcePath).c_str()) || file.size() < sizeof(MeshCacheHeader)) {
+        cacheStats.misses++;
+        return false;
+    }
+
+    MeshCacheHeader& header = view.header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    size_t vertexBytes = static_cast<size_t>(header.vertexCount) * MESH_VERTEX_FLOATS * sizeof(float);
+    size_t indexBytes = static_cast<size_t>(header.indexCount) * header.indexSize;
+    bool valid = std::memcmp(header.magic, "OGLM", 4) == 0
+        && header.version == MESH_CACHE_VERSION
+        && header.sourceSize == size
+        && header.sourceMtime == mtime
+        && header.vertexFloats == MESH_VERTEX_FLOATS
+        && (header.indexSize == 2 || header.indexSize == 4)
+        && header.vertexCount > 0 && header.indexCount > 0
+        && header.lodCount >= 1 && header.lodCount <= (uint32_t)MESH_MAX_LODS
+        && file.size() == sizeof(MeshCacheHeader) + vertexBytes + indexBytes;
+    for (uint32_t l = 0; valid && l < header.lodCount; ++l) {
+        const MeshLod& lod = header.lods[l];
+        valid = lod.firstIndex >= 0 && lod.indexCount > 0
+            && (uint32_t)lod.firstIndex + (uint32_t)lod.indexCount <= header.indexCount;
+    }
+    if (!valid) {
+        file.close();
+        cacheStats.misses++;
+        return false;
+    }
+
+    view.vertices = reinterpret_cast<const float*>(file.data() + sizeof(MeshCacheHeader));
+    view.indices = file.data() + sizeof(MeshCacheHeader) + vertexBytes;
+    cacheStats.hits++;
+    return true;
+}
+
+void uploadMeshCache(const MeshCacheView& view, Mesh& mesh)
+{
+    uploadMesh(view.vertices, static_cast<int>(view.header.vertexCount), view.indices,
+        static_cast<int>(view.header.indexCount), view.indexType(), mesh, view.header.lods, static_cast<int>(view.header.lodCount));
+}
+
+bool loadMeshCache(const char* sourcePath, Mesh& mesh)
+{
+    MeshCacheView view;
+    if (!openMeshCache(sourcePath, view)) return false;
+    uploadMeshCache(view, mesh);
+    return true;
+}
+
+bool storeMeshCache(const char* sourcePath, const MeshData& data)
+{
+    uint64_t size = 0; int64_t mtime = 0;
+    if (!sourceStamp(sourcePath, size, mtime)) return false;
+
+    std::error_code ec;
+    fs::create_directories(MESH_CACHE_DIR, ec);
+
+    int vertexCount = static_cast<int>(data.vertices.size() / MESH_VERTEX_FLOATS);
+    GLenum indexType = meshIndexType(vertexCount);
+    std::vector<unsigned char> indices = packIndices(data.indices, indexType);
+
+    MeshCacheHeader header = {};
+    std::memcpy(header.magic, "OGLM", 4);
+    header.version = MESH_CACHE_VERSION;
+    header.sourceSize = size;
+    header.sourceMtime = mtime;
+    header.vertexCount = static_cast<uint32_t>(vertexCount);
+    header.indexCount = static_cast<uint32_t>(data.indices.size());
+    header.indexSize = indexType == GL_UNSIGNED_SHORT ? 2 : 4;
+    header.vertexFloats = MESH_VERTEX_FLOATS;
+    if (data.lods.empty()) {
+        header.lodCount = 1;
+        header.lods[0] = { 0, static_cast<int>(data.indices.size()) };
+    }
+    else {
+        header.lodCount = static_cast<uint32_t>(std::min<size_t>(data.lods.size(), MESH_MAX_LODS));
+        for (uint32_t l = 0; l < header.lodCount; ++l) header.lods[l] = data.lods[l];
+    }
+
+    // zapis do pliku tymczasowego i rename, zeby przerwany zapis nie zostawil uszkodzonego cache
+    std::string path = cachePathFor(sourcePath);
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "ERROR: Cannot write mesh cache: " << tmpPath << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(data.vertices.data()), data.vertices.size() * sizeof(float));
+        out.write(reinterpret_cast<const char*>(indices.data()), indices.size());
+        if (!out) return false;
+    }
+    fs::rename(tmpPath, path, ec);
+    return !ec;
+}
+
+const MeshCacheStats& meshCacheStats()
+{
+    return cacheStats;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef MESH_CACHE_CLASS_H
+#define MESH_CACHE_CLASS_H
+
+#include "Mesh.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Binarny cache siatek: naglowek (z tabela LOD) + wierzcholki (8 floatow) + indeksy (16/32 bit)
+// zapisane tak, jak ida do glBufferData. Plik jest mapowany do pamieci i
+// wysylany na GPU bez parsowania. Klucz: sciezka zrodla (nazwa pliku cache),
+// rozmiar i czas modyfikacji (w naglowku).
+const char MESH_CACHE_DIR[] = "meshcache";
+const uint32_t MESH_CACHE_VERSION = 2;
+
+struct MeshCacheHeader
+{
+    char     magic[4];          // "OGLM"
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t  sourceMtime;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t indexSize;         // 2 albo 4 bajty
+    uint32_t vertexFloats;      // MESH_VERTEX_FLOATS
+    uint32_t lodCount;          // 1..MESH_MAX_LODS, zakresy indeksow w lods
+    MeshLod  lods[MESH_MAX_LODS];
+};
+
+struct MeshCacheStats
+{
+    std::atomic<int> hits{ 0 };
+    std::atomic<int> misses{ 0 };
+};
+
+// Plik zmapowany tylko do odczytu (mmap / MapViewOfFile)
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const char* path);
+    void close();
+
+    const unsigned char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const unsigned char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+// Zwalidowany, zmapowany plik cache - wskazniki prosto do glBufferData.
+struct MeshCacheView
+{
+    MappedFile file;
+    MeshCacheHeader header = {};
+    const float* vertices = nullptr;
+    const void* indices = nullptr;
+
+    GLenum indexType() const { return header.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT; }
+};
+
+// mapowanie i walidacja bez GL - mozna wolac z watku roboczego
+bool openMeshCache(const char* sourcePath, MeshCacheView& view);
+void uploadMeshCache(const MeshCacheView& view, Mesh& mesh);
+
+bool loadMeshCache(const char* sourcePath, Mesh& mesh);
+bool storeMeshCache(const char* sourcePath, const MeshData& data);
+const MeshCacheStats& meshCacheStats();
+
+#endif
@@ -0,0 +1,302 @@
+#include "MeshSimplify.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+
+namespace
+{
+    // symetryczna macierz 4x4 kwadryki: a00 a01 a02 a03 a11 a12 a13 a22 a23 a33
+    struct Quadric
+    {
+        double a[10] = { 0.0 };
+
+        void addPlane(double nx, double ny, double nz, double d, double weight)
+        {
+            a[0] += weight * nx * nx; a[1] += weight * nx * ny; a[2] += weight * nx * nz; a[3] += weight * nx * d;
+            a[4] += weight * ny * ny; a[5] += weight * ny * nz; a[6] += weight * ny * d;
+            a[7] += weight * nz * nz; a[8] += weight * nz * d;
+            a[9] += weight * d * d;
+        }
+
+        void add(const Quadric& q)
+        {
+            for (int i = 0; i < 10; ++i) a[i] += q.a[i];
+        }
+
+        // v^T Q v dla v = (x, y, z, 1)
+        double evaluate(double x, double y, double z) const
+        {
+            return a[0] * x * x + 2.0 * a[1] * x * y + 2.0 * a[2] * x * z + 2.0 * a[3] * x
+                + a[4] * y * y + 2.0 * a[5] * y * z + 2.0 * a[6] * y
+                + a[7] * z * z + 2.0 * a[8] * z
+                + a[9];
+        }
+    };
+
+    struct Collapse
+    {
+        double cost;
+        int from, to;
+        unsigned int fromVersion, toVersion;
+
+        bool operator<(const Collapse& o) const { return cost > o.cost; }   //najtanszy na szczycie kolejki
+    };
+
+    struct PositionKey
+    {
+        uint32_t x, y, z;
+        bool operator==(const PositionKey& o) const { return x == o.x && y == o.y && z == o.z; }
+    };
+
+    struct PositionKeyHash
+    {
+        size_t operator()(const PositionKey& k) const
+        {
+            return (size_t)k.x * 73856093u ^ (size_t)k.y * 19349663u ^ (size_t)k.z * 83492791u;
+        }
+    };
+
+    // sciana z obciazeniem krawedzi brzegowych, zeby kontur siatki sie nie kurczyl
+    const double BORDER_WEIGHT = 10.0;
+    // minimalny cosinus miedzy normalna trojkata przed i po sciagnieciu
+    const double MAX_FLIP_COS = 0.2;
+    // mniejsze LOD-y nic nie oszczedzaja, a psuja ksztalt
+    const int MIN_LOD_TRIANGLES = 64;
+}
+
+std::vector<unsigned int> simplifyMesh(const float* vertices, int vertexCount, const std::vector<unsigned int>& indices,
+    int targetIndexCount)
+{
+    auto position = [vertices](int v) { return vertices + (size_t)v * MESH_VERTEX_FLOATS; };
+
+    //sklejanie po pozycji: kazdy wierzcholek -> pierwszy o tej samej pozycji
+    std::vector<int> weld(vertexCount);
+    {
+        std::unordered_map<PositionKey, int, PositionKeyHash> first;
+        first.reserve(vertexCount);
+        for (int v = 0; v < vertexCount; ++v) {
+            PositionKey key;
+            std::memcpy(&key, position(v), sizeof(key));
+            weld[v] = first.emplace(key, v).first->second;
+        }
+    }
+
+    //tris: sklejone wierzcholki (sasiedztwo, kwadryki); corners: wierzcholki z atrybutami do wyniku
+    std::vector<int> tris, corners;
+    tris.reserve(indices.size());
+    corners.reserve(indices.size());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        int a = weld[indices[i]], b = weld[indices[i + 1]], c = weld[indices[i + 2]];
+        if (a == b || b == c || a == c) continue;
+        tris.push_back(a); tris.push_back(b); tris.push_back(c);
+        for (int k = 0; k < 3; ++k) corners.push_back(static_cast<int>(indices[i + k]));
+    }
+    int triCount = static_cast<int>(tris.size() / 3);
+
+    //kwadryki plaszczyzn trojkatow (waga = pole) i sasiedztwo wierzcholek -> trojkaty
+    std::vector<Quadric> quadrics(vertexCount);
+    std::vector<std::vector<int>> adjacency(vertexCount);
+    std::unordered_map<uint64_t, int> edgeUse;
+    for (int t = 0; t < triCount; ++t) {
+        const int* v = &tris[3 * t];
+        const float* p0 = position(v[0]);
+        const float* p1 = position(v[1]);
+        const float* p2 = position(v[2]);
+        double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        double n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length > 0.0) {
+            n[0] /= length; n[1] /= length; n[2] /= length;
+            double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+            for (int k = 0; k < 3; ++k) quadrics[v[k]].addPlane(n[0], n[1], n[2], d, length * 0.5);
+        }
+        for (int k = 0; k < 3; ++k) {
+            adjacency[v[k]].push_back(t);
+            int a = std::min(v[k], v[(k + 1) % 3]), b = std::max(v[k], v[(k + 1) % 3]);
+            edgeUse[(uint64_t)a << 32 | (uint32_t)b]++;
+        }
+    }
+
+    //krawedzie brzegowe: plaszczyzna przez krawedz prostopadla do trojkata
+    for (int t = 0; t < triCount; ++t) {
+        const int* v = &tris[3 * t];
+        const float* p0 = position(v[0]);
+        const float* p1 = position(v[1]);
+        const float* p2 = position(v[2]);
+        double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        double n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        for (int k = 0; k < 3; ++k) {
+            int a = v[k], b = v[(k + 1) % 3];
+            if (edgeUse[(uint64_t)std::min(a, b) << 32 | (uint32_t)std::max(a, b)] != 1) continue;
+            const float* pa = position(a);
+            const float* pb = position(b);
+            double e[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+            double m[3] = { e[1] * n[2] - e[2] * n[1], e[2] * n[0] - e[0] * n[2], e[0] * n[1] - e[1] * n[0] };
+            double length = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+            if (length == 0.0) continue;
+            m[0] /= length; m[1] /= length; m[2] /= length;
+            double d = -(m[0] * pa[0] + m[1] * pa[1] + m[2] * pa[2]);
+            double weight = BORDER_WEIGHT * (e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+            quadrics[a].addPlane(m[0], m[1], m[2], d, weight);
+            quadrics[b].addPlane(m[0], m[1], m[2], d, weight);
+        }
+    }
+
+    std::vector<unsigned int> version(vertexCount, 0);
+    std::vector<char> removed(triCount, 0);
+    std::vector<char> dead(vertexCount, 0);
+    std::priority_queue<Collapse> heap;
+
+    auto collapseCost = [&](int from, int to) {
+        Quadric q = quadrics[from];
+        q.add(quadrics[to]);
+        const float* p = position(to);
+        return std::max(0.0, q.evaluate(p[0], p[1], p[2]));
+    };
+    auto pushEdges = [&](int v) {
+        for (int t : adjacency[v]) {
+            if (removed[t]) continue;
+            for (int k = 0; k < 3; ++k) {
+                int u = tris[3 * t + k];
+                if (u == v) continue;
+                heap.push({ collapseCost(v, u), v, u, version[v], version[u] });
+                heap.push({ collapseCost(u, v), u, v, version[u], version[v] });
+            }
+        }
+    };
+    for (int v = 0; v < vertexCount; ++v)
+        if (weld[v] == v && !adjacency[v].empty()) pushEdges(v);
+
+    //czy po przeniesieniu from -> to zaden trojkat sie nie odwroci
+    auto flips = [&](int from, int to) {
+        const float* pt = position(to);
+        for (int t : adjacency[from]) {
+            if (removed[t]) continue;
+            const int* v = &tris[3 * t];
+            if (v[0] == to || v[1] == to || v[2] == to) continue;
+            const float* p[3] = { position(v[0]), position(v[1]), position(v[2]) };
+            double before[3], after[3];
+            for (int pass = 0; pass < 2; ++pass) {
+                const float* q[3] = { p[0], p[1], p[2] };
+                if (pass == 1) for (int k = 0; k < 3; ++k) if (v[k] == from) q[k] = pt;
+                double e1[3] = { q[1][0] - q[0][0], q[1][1] - q[0][1], q[1][2] - q[0][2] };
+                double e2[3] = { q[2][0] - q[0][0], q[2][1] - q[0][1], q[2][2] - q[0][2] };
+                double* n = pass == 0 ? before : after;
+                n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+                n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+                n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+            }
+            double dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+            double lb = std::sqrt(before[0] * before[0] + before[1] * before[1] + before[2] * before[2]);
+            double la = std::sqrt(after[0] * after[0] + after[1] * after[1] + after[2] * after[2]);
+            if (la == 0.0 || dot < MAX_FLIP_COS * lb * la) return true;
+        }
+        return false;
+    };
+
+    //kopia "from" -> kopia "to" z tego samego trojkata (ta sama wyspa uv/normalnych). Bez pary
+    //dla ktorejs kopii sciagniecie przeszloby przez szew - wtedy jest odrzucane
+    std::vector<std::pair<int, int>> copies;
+    auto mapCopies = [&](int from, int to) {
+        copies.clear();
+        for (int t : adjacency[from]) {
+            if (removed[t]) continue;
+            const int* v = &tris[3 * t];
+            int kf = -1, kt = -1;
+            for (int k = 0; k < 3; ++k) {
+                if (v[k] == from) kf = k;
+                if (v[k] == to) kt = k;
+            }
+            if (kt < 0) continue;
+            int f = corners[3 * t + kf], c = corners[3 * t + kt];
+            auto known = std::find_if(copies.begin(), copies.end(), [f](const std::pair<int, int>& p) { return p.first == f; });
+            if (known == copies.end()) copies.push_back({ f, c });
+            else if (known->second != c) return false;
+        }
+        for (int t : adjacency[from]) {
+            if (removed[t]) continue;
+            for (int k = 0; k < 3; ++k) {
+                if (tris[3 * t + k] != from) continue;
+                int f = corners[3 * t + k];
+                if (std::none_of(copies.begin(), copies.end(), [f](const std::pair<int, int>& p) { return p.first == f; }))
+                    return false;
+            }
+        }
+        return true;
+    };
+    auto copyOf = [&copies](int f) {
+        return std::find_if(copies.begin(), copies.end(), [f](const std::pair<int, int>& p) { return p.first == f; })->second;
+    };
+
+    int targetTris = std::max(1, targetIndexCount / 3);
+    while (triCount > targetTris && !heap.empty()) {
+        Collapse c = heap.top();
+        heap.pop();
+        if (dead[c.from] || dead[c.to]) continue;
+        if (version[c.from] != c.fromVersion || version[c.to] != c.toVersion) continue;
+        if (!mapCopies(c.from, c.to)) continue;
+        if (flips(c.from, c.to)) continue;
+
+        //from znika: trojkaty z krawedzia (from, to) sie zapadaja, reszta przechodzi na to
+        for (int t : adjacency[c.from]) {
+            if (removed[t]) continue;
+            int* v = &tris[3 * t];
+            if (v[0] == c.to || v[1] == c.to || v[2] == c.to) {
+                removed[t] = 1;
+                triCount--;
+                continue;
+            }
+            for (int k = 0; k < 3; ++k) {
+                if (v[k] != c.from) continue;
+                v[k] = c.to;
+                corners[3 * t + k] = copyOf(corners[3 * t + k]);
+            }
+            adjacency[c.to].push_back(t);
+        }
+        dead[c.from] = 1;
+        adjacency[c.from].clear();
+        quadrics[c.to].add(quadrics[c.from]);
+
+        //zmienila sie tylko kwadryka "to": jej stare krawedzie w kolejce przestaja byc wazne
+        std::vector<int>& around = adjacency[c.to];
+        around.erase(std::remove_if(around.begin(), around.end(), [&removed](int t) { return removed[t] != 0; }), around.end());
+        version[c.to]++;
+        pushEdges(c.to);
+    }
+
+    std::vector<unsigned int> result;
+    result.reserve((size_t)triCount * 3);
+    for (size_t t = 0; t < removed.size(); ++t) {
+        if (removed[t]) continue;
+        for (int k = 0; k < 3; ++k) result.push_back(static_cast<unsigned int>(corners[3 * t + k]));
+    }
+    return result;
+}
+
+void generateMeshLods(MeshData& data)
+{
+    const float RATIOS[MESH_MAX_LODS - 1] = { 0.5f, 0.25f, 0.1f };
+
+    int vertexCount = static_cast<int>(data.vertices.size() / MESH_VERTEX_FLOATS);
+    int fullCount = static_cast<int>(data.indices.size());
+    data.lods.clear();
+    data.lods.push_back({ 0, fullCount });
+
+    //kazdy poziom upraszczany z pelnej siatki - bledy sie nie kumuluja
+    std::vector<unsigned int> full = data.indices;
+    for (float ratio : RATIOS) {
+        int target = static_cast<int>(fullCount * ratio) / 3 * 3;
+        if (target < MIN_LOD_TRIANGLES * 3) break;
+        std::vector<unsigned int> lod = simplifyMesh(data.vertices.data(), vertexCount, full, target);
+        int previous = data.lods.back().indexCount;
+        if (lod.empty() || lod.size() > previous * 0.8f) break;
+
+        data.lods.push_back({ static_cast<int>(data.indices.size()), static_cast<int>(lod.size()) });
+        data.indices.insert(data.indices.end(), lod.begin(), lod.end());
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+#ifndef MESH_SIMPLIFY_CLASS_H
+#define MESH_SIMPLIFY_CLASS_H
+
+#include <vector>
+
+#include "Mesh.h"
+
+// Upraszczanie siatki metryka bledu kwadrykowego (Garland-Heckbert) przez
+// sciaganie krawedzi do jednego z koncow: wynik to nowe indeksy do tych
+// samych wierzcholkow, wiec wszystkie LOD-y dziela jeden VBO. Wierzcholki
+// o tej samej pozycji (szwy uv/normalnych) sa sklejane tylko dla sasiedztwa
+// i kwadryk: kazdy naroznik zachowuje wierzcholek ze swoimi atrybutami, a
+// sciagniecia przez szew sa odrzucane.
+// Zwraca indeksy (co najwyzej targetIndexCount, jesli sie da).
+std::vector<unsigned int> simplifyMesh(const float* vertices, int vertexCount, const std::vector<unsigned int>& indices,
+    int targetIndexCount);
+
+// Dopisuje do data.indices kolejne LOD-y (50%, 25%, 10% trojkatow) i wypelnia
+// data.lods. Poziom, ktory niewiele zmniejsza siatke albo mialby mniej niz
+// 64 trojkaty, konczy lancuch.
+void generateMeshLods(MeshData& data);
+
+#endif
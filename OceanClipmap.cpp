@@ -0,0 +1,107 @@
+#include "OceanClipmap.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+OceanClipmap::OceanClipmap(const OceanClipmapParams& params) : clipmapParams(params)
+{
+    const int n = clipmapParams.gridHalf;
+    const int side = 2 * n + 1;
+
+    //wspolna siatka w jednostkach oczek: pozycja (i, 0, j), normalna w gore
+    MeshData data;
+    data.vertices.reserve(side * side * MESH_VERTEX_FLOATS);
+    for (int j = -n; j <= n; ++j) {
+        for (int i = -n; i <= n; ++i) {
+            float vertex[MESH_VERTEX_FLOATS] = { (float)i, 0.0f, (float)j, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f };
+            data.vertices.insert(data.vertices.end(), vertex, vertex + MESH_VERTEX_FLOATS);
+        }
+    }
+
+    auto vertexIndex = [&](int i, int j) { return (unsigned int)((j + n) * side + (i + n)); };
+    //holeX/holeZ: przesuniecie dziury; bez dziury gdy hole == false
+    auto appendQuads = [&](bool hole, int holeX, int holeZ) {
+        IndexRange range;
+        range.offset = data.indices.size();
+        for (int j = -n; j < n; ++j) {
+            for (int i = -n; i < n; ++i) {
+                bool insideX = i >= holeX - n / 2 && i + 1 <= holeX + n / 2;
+                bool insideZ = j >= holeZ - n / 2 && j + 1 <= holeZ + n / 2;
+                if (hole && insideX && insideZ) continue;
+                unsigned int tl = vertexIndex(i, j), tr = vertexIndex(i + 1, j);
+                unsigned int bl = vertexIndex(i, j + 1), br = vertexIndex(i + 1, j + 1);
+                data.indices.push_back(tl); data.indices.push_back(bl); data.indices.push_back(tr);
+                data.indices.push_back(tr); data.indices.push_back(bl); data.indices.push_back(br);
+            }
+        }
+        range.count = (GLsizei)(data.indices.size() - range.offset);
+        return range;
+    };
+
+    fullRange = appendQuads(false, 0, 0);
+    for (int dz = -1; dz <= 1; ++dz)
+        for (int dx = -1; dx <= 1; ++dx)
+            ringRanges[dz + 1][dx + 1] = appendQuads(true, dx, dz);
+
+    uploadMesh(data, grid);
+
+    //offsety w bajtach zaleza od typu indeksow wybranego przy uploadzie
+    size_t indexSize = grid.indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+    fullRange.offset *= indexSize;
+    for (int z = 0; z < 3; ++z)
+        for (int x = 0; x < 3; ++x)
+            ringRanges[z][x].offset *= indexSize;
+
+    float extent = n * clipmapParams.baseSpacing * std::ldexp(1.0f, clipmapParams.levels - 1);
+    std::cout << "INFO: Ocean clipmap: " << clipmapParams.levels << " poziomow, " << grid.vertexCount
+              << " wierzcholkow siatki, zasieg +-" << extent << ", trojkatow na klatke: " << trianglesPerFrame() << std::endl;
+}
+
+void OceanClipmap::bind(Shader& shader)
+{
+    centerLoc = shader.uniform("clipmapCenter");
+    spacingLoc = shader.uniform("clipmapSpacing");
+    shader.Activate();
+    shader.setInt("clipmapGridHalf", clipmapParams.gridHalf);
+    shader.setFloat("clipmapMorphWidth", clipmapParams.morphWidth);
+}
+
+void OceanClipmap::draw(const Shader& shader, const glm::vec3& cameraPos) const
+{
+    glm::vec2 camera(cameraPos.x, cameraPos.z);
+    glBindVertexArray(grid.vao);
+
+    glm::vec2 innerCenter(0.0f);
+    for (int level = 0; level < clipmapParams.levels; ++level) {
+        float spacing = clipmapParams.baseSpacing * std::ldexp(1.0f, level);
+        //srodek w wielokrotnosci 2*s, zeby parzyste wierzcholki lezaly na siatce poziomu wyzej
+        glm::vec2 center = glm::floor(camera / (2.0f * spacing) + 0.5f) * (2.0f * spacing);
+
+        const IndexRange* range = &fullRange;
+        if (level > 0) {
+            glm::vec2 hole = glm::floor((innerCenter - center) / spacing + 0.5f);
+            int hx = (int)hole.x, hz = (int)hole.y;
+            range = &ringRanges[hz + 1][hx + 1];
+        }
+
+        shader.setVec2(centerLoc, center);
+        shader.setFloat(spacingLoc, spacing);
+        glDrawElements(GL_TRIANGLES, range->count, grid.indexType, (void*)range->offset);
+        innerCenter = center;
+    }
+    glBindVertexArray(0);
+}
+
+int OceanClipmap::trianglesPerFrame() const
+{
+    int total = fullRange.count / 3;
+    if (clipmapParams.levels > 1)
+        total += (clipmapParams.levels - 1) * (ringRanges[1][1].count / 3);
+    return total;
+}
+
+void OceanClipmap::Delete()
+{
+    grid.Delete();
+}
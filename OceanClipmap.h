@@ -0,0 +1,57 @@
+#pragma once
+#ifndef OCEAN_CLIPMAP_CLASS_H
+#define OCEAN_CLIPMAP_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+#include "Mesh.h"
+#include "shaderClass.h"
+
+struct OceanClipmapParams
+{
+    int   gridHalf = 32;        // n: siatka poziomu ma (2n+1)^2 wierzcholkow, n parzyste
+    int   levels = 7;           // zasieg = n * baseSpacing * 2^(levels-1)
+    float baseSpacing = 0.5f;   // odstep wierzcholkow najblizszego poziomu
+    float morphWidth = 8.0f;    // szerokosc pasa przejscia przy krawedzi poziomu (w oczkach)
+};
+
+// Geometry clipmap oceanu: zagniezdzone pierscienie tej samej siatki,
+// odstep podwaja sie z kazdym poziomem, srodki przyciagane do kamery.
+// Poziom l ma srodek zaokraglony do 2*s_l, wiec dziura na poziom l-1 jest
+// przesunieta o {-1,0,1} oczek w x i z - 9 gotowych zakresow indeksow.
+// Wierzcholki przy zewnetrznej krawedzi poziomu sa w shaderze sciagane
+// na siatke poziomu wyzej, wiec szwy sa bez pekniec.
+class OceanClipmap
+{
+public:
+    explicit OceanClipmap(const OceanClipmapParams& params = OceanClipmapParams());
+
+    const OceanClipmapParams& params() const { return clipmapParams; }
+
+    // pobiera lokacje uniformow clipmapy i ustawia stale
+    void bind(Shader& shader);
+    // rysuje wszystkie poziomy wokol kamery; shader musi byc aktywny
+    void draw(const Shader& shader, const glm::vec3& cameraPos) const;
+    void Delete();
+
+    int trianglesPerFrame() const;
+
+private:
+    struct IndexRange
+    {
+        GLsizei count = 0;
+        size_t  offset = 0;     // w bajtach
+    };
+
+    OceanClipmapParams clipmapParams;
+    Mesh grid;
+    IndexRange fullRange;               // poziom 0, bez dziury
+    IndexRange ringRanges[3][3];        // [z+1][x+1] przesuniecie dziury
+
+    UniformHandle centerLoc;
+    UniformHandle spacingLoc;
+};
+
+#endif
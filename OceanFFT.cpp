@@ -0,0 +1,350 @@
+#include "OceanFFT.h"
+
+#include <cmath>
+#include <random>
+#include <iostream>
+#include <algorithm>
+
+static const float GRAVITY = 9.81f;
+static const float PI = 3.14159265358979f;
+
+typedef std::complex<float> cfloat;
+
+OceanFFT::OceanFFT(const OceanSpectrumParams& params)
+    : spectrumParams(params)
+{
+    generateSpectrum();
+}
+
+// k = 2*pi*(n - N/2)/L, n - indeks kolumny (x), m - indeks wiersza (z)
+glm::vec2 OceanFFT::waveVector(int n, int m) const
+{
+    int N = spectrumParams.resolution;
+    float L = spectrumParams.patchSize;
+    return glm::vec2(2.0f * PI * (n - N / 2) / L, 2.0f * PI * (m - N / 2) / L);
+}
+
+float OceanFFT::omega(int n, int m) const
+{
+    return std::sqrt(GRAVITY * glm::length(waveVector(n, m)));
+}
+
+void OceanFFT::generateSpectrum()
+{
+    int N = spectrumParams.resolution;
+    float windSpeed = glm::length(spectrumParams.wind);
+    glm::vec2 windDir = spectrumParams.wind / windSpeed;
+    float Lw = windSpeed * windSpeed / GRAVITY;   // najwieksza fala dla danego wiatru
+    float damping = Lw * 0.001f;                  // tlumienie bardzo krotkich fal
+
+    auto phillips = [&](glm::vec2 k) {
+        float k2 = glm::dot(k, k);
+        if (k2 < 1e-12f) return 0.0f;
+        float kdotw = glm::dot(k / std::sqrt(k2), windDir);
+        float p = spectrumParams.amplitude * std::exp(-1.0f / (k2 * Lw * Lw)) / (k2 * k2) * kdotw * kdotw;
+        if (kdotw < 0.0f) p *= 0.07f;             // fale przeciw wiatrowi sa slabsze
+        return p * std::exp(-k2 * damping * damping);
+    };
+
+    std::mt19937 rng(spectrumParams.seed);
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+
+    h0.assign(N * N, cfloat(0.0f));
+    for (int m = 0; m < N; ++m) {
+        for (int n = 0; n < N; ++n) {
+            float p = std::sqrt(phillips(waveVector(n, m)) * 0.5f);
+            float re = gauss(rng), im = gauss(rng);
+            h0[m * N + n] = cfloat(re * p, im * p);
+        }
+    }
+
+    // -k dla indeksu n to N - n (mod N)
+    h0MinusConj.assign(N * N, cfloat(0.0f));
+    for (int m = 0; m < N; ++m)
+        for (int n = 0; n < N; ++n)
+            h0MinusConj[m * N + n] = std::conj(h0[((N - m) % N) * N + (N - n) % N]);
+}
+
+// Stockham radix-2, wersja "gather": kazdy element wyjscia liczony niezaleznie,
+// dokladnie tak jak w ocean_fft.frag. Wynik w naturalnej kolejnosci.
+void OceanFFT::inverseFFT(std::vector<cfloat>& data, std::vector<cfloat>& scratch)
+{
+    int N = static_cast<int>(data.size());
+    scratch.resize(N);
+    std::vector<cfloat>* src = &data;
+    std::vector<cfloat>* dst = &scratch;
+    for (int Ns = 1; Ns < N; Ns *= 2) {
+        for (int i = 0; i < N; ++i) {
+            int k = i % (2 * Ns);
+            int r = k >= Ns ? 1 : 0;
+            int jm = k - r * Ns;
+            int j = (i / (2 * Ns)) * Ns + jm;
+            float angle = 2.0f * PI * jm / (2.0f * Ns);
+            cfloat w(std::cos(angle), std::sin(angle));
+            cfloat a = (*src)[j];
+            cfloat b = (*src)[j + N / 2] * w;
+            (*dst)[i] = r ? a - b : a + b;
+        }
+        std::swap(src, dst);
+    }
+    if (src != &data) data = *src;
+}
+
+float OceanFFT::selfTest(int n)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<cfloat> data(n), scratch;
+    for (cfloat& c : data) c = cfloat(dist(rng), dist(rng));
+
+    std::vector<cfloat> reference(n);
+    for (int x = 0; x < n; ++x) {
+        std::complex<double> sum(0.0);
+        for (int k = 0; k < n; ++k) {
+            double angle = 2.0 * 3.14159265358979323846 * k * x / n;
+            sum += std::complex<double>(data[k]) * std::complex<double>(std::cos(angle), std::sin(angle));
+        }
+        reference[x] = cfloat(sum);
+    }
+
+    inverseFFT(data, scratch);
+    float maxError = 0.0f;
+    for (int x = 0; x < n; ++x) maxError = std::max(maxError, std::abs(data[x] - reference[x]));
+    return maxError;
+}
+
+void OceanFFT::computeCPU(float time, std::vector<glm::vec4>& displacement, std::vector<glm::vec4>& normals) const
+{
+    int N = spectrumParams.resolution;
+    // pola: h, Dx, Dz, slope x, slope z
+    std::vector<cfloat> fields[5];
+    for (auto& f : fields) f.assign(N * N, cfloat(0.0f));
+
+    for (int m = 0; m < N; ++m) {
+        for (int n = 0; n < N; ++n) {
+            int idx = m * N + n;
+            float w = omega(n, m) * time;
+            cfloat e(std::cos(w), std::sin(w));
+            cfloat h = h0[idx] * e + h0MinusConj[idx] * std::conj(e);
+            glm::vec2 k = waveVector(n, m);
+            float len = glm::length(k);
+            glm::vec2 kn = len > 1e-6f ? k / len : glm::vec2(0.0f);
+            fields[0][idx] = h;
+            fields[1][idx] = cfloat(0.0f, -kn.x) * h;
+            fields[2][idx] = cfloat(0.0f, -kn.y) * h;
+            fields[3][idx] = cfloat(0.0f, k.x) * h;
+            fields[4][idx] = cfloat(0.0f, k.y) * h;
+        }
+    }
+
+    // 2D = FFT wierszy (x), potem kolumn (z)
+    std::vector<cfloat> line(N), scratch;
+    for (auto& f : fields) {
+        for (int m = 0; m < N; ++m) {
+            std::copy(f.begin() + m * N, f.begin() + (m + 1) * N, line.begin());
+            inverseFFT(line, scratch);
+            std::copy(line.begin(), line.end(), f.begin() + m * N);
+        }
+        for (int n = 0; n < N; ++n) {
+            for (int m = 0; m < N; ++m) line[m] = f[m * N + n];
+            inverseFFT(line, scratch);
+            for (int m = 0; m < N; ++m) f[m * N + n] = line[m];
+        }
+    }
+
+    float lambda = spectrumParams.choppiness;
+    displacement.resize(N * N);
+    normals.resize(N * N);
+    for (int m = 0; m < N; ++m) {
+        for (int n = 0; n < N; ++n) {
+            int idx = m * N + n;
+            // przesuniecie indeksow k o N/2 daje czynnik (-1)^(n+m)
+            float sign = ((n + m) & 1) ? -1.0f : 1.0f;
+            float h = fields[0][idx].real() * sign;
+            float dx = fields[1][idx].real() * sign * lambda;
+            float dz = fields[2][idx].real() * sign * lambda;
+            float sx = fields[3][idx].real() * sign;
+            float sz = fields[4][idx].real() * sign;
+            displacement[idx] = glm::vec4(dx, h, dz, 0.0f);
+            glm::vec3 normal = glm::normalize(glm::vec3(-sx, 1.0f, -sz));
+            normals[idx] = glm::vec4(normal, 0.0f);
+        }
+    }
+}
+
+static GLuint createFloatTexture(int size, GLenum filter, GLenum wrap)
+{
+    GLuint tex;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, size, size, 0, GL_RGBA, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    return tex;
+}
+
+void OceanFFT::initGPU()
+{
+    int N = spectrumParams.resolution;
+
+    spectrumShader = new Shader("ocean_fft.vert", "ocean_spectrum.frag");
+    fftShader = new Shader("ocean_fft.vert", "ocean_fft.frag");
+    resolveShader = new Shader("ocean_fft.vert", "ocean_resolve.frag");
+
+    // h0(k) i conj(h0(-k)) w jednej teksturze RGBA32F
+    std::vector<float> h0Data(N * N * 4);
+    for (int i = 0; i < N * N; ++i) {
+        h0Data[i * 4 + 0] = h0[i].real();
+        h0Data[i * 4 + 1] = h0[i].imag();
+        h0Data[i * 4 + 2] = h0MinusConj[i].real();
+        h0Data[i * 4 + 3] = h0MinusConj[i].imag();
+    }
+    h0Tex = createFloatTexture(N, GL_NEAREST, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, N, N, 0, GL_RGBA, GL_FLOAT, h0Data.data());
+
+    const GLenum drawBuffers[3] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+    glGenFramebuffers(2, pingFBO);
+    for (int p = 0; p < 2; ++p) {
+        glBindFramebuffer(GL_FRAMEBUFFER, pingFBO[p]);
+        for (int t = 0; t < 3; ++t) {
+            pingTex[p][t] = createFloatTexture(N, GL_NEAREST, GL_CLAMP_TO_EDGE);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + t, GL_TEXTURE_2D, pingTex[p][t], 0);
+        }
+        glDrawBuffers(3, drawBuffers);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cerr << "ERROR::FRAMEBUFFER:: Ocean FFT framebuffer is not complete!" << std::endl;
+    }
+
+    // wynik probkowany w ocean.vert - powtarzany kafel, filtrowanie liniowe
+    displacementTex = createFloatTexture(N, GL_LINEAR, GL_REPEAT);
+    normalTex = createFloatTexture(N, GL_LINEAR, GL_REPEAT);
+    glGenFramebuffers(1, &resolveFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, resolveFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, displacementTex, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normalTex, 0);
+    glDrawBuffers(2, drawBuffers);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "ERROR::FRAMEBUFFER:: Ocean resolve framebuffer is not complete!" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenVertexArrays(1, &emptyVAO);
+
+    spectrumShader->use();
+    spectrumShader->setInt("h0Texture", 0);
+    spectrumShader->setInt("resolution", N);
+    spectrumShader->setFloat("patchSize", spectrumParams.patchSize);
+    spectrumTimeLoc = spectrumShader->uniform("spectrumTime");
+
+    fftShader->use();
+    fftShader->setInt("input0", 0);
+    fftShader->setInt("input1", 1);
+    fftShader->setInt("input2", 2);
+    fftShader->setInt("resolution", N);
+    fftStageLoc = fftShader->uniform("stage");
+    fftVerticalLoc = fftShader->uniform("vertical");
+
+    resolveShader->use();
+    resolveShader->setInt("input0", 0);
+    resolveShader->setInt("input1", 1);
+    resolveShader->setInt("input2", 2);
+    resolveShader->setFloat("choppiness", spectrumParams.choppiness);
+
+    std::cout << "INFO: Ocean FFT " << N << "x" << N << ", kafel " << spectrumParams.patchSize << " m" << std::endl;
+}
+
+void OceanFFT::update(float time)
+{
+    int N = spectrumParams.resolution;
+
+    GLint viewport[4];
+    GLint previousFBO = 0;
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glViewport(0, 0, N, N);
+    glBindVertexArray(emptyVAO);
+
+    // h(k, t) -> ping[0]
+    glBindFramebuffer(GL_FRAMEBUFFER, pingFBO[0]);
+    spectrumShader->use();
+    spectrumShader->setFloat(spectrumTimeLoc, time);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, h0Tex);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    // log2(N) przebiegow w poziomie, potem log2(N) w pionie
+    fftShader->use();
+    int src = 0;
+    for (int vertical = 0; vertical < 2; ++vertical) {
+        fftShader->setInt(fftVerticalLoc, vertical);
+        for (int Ns = 1; Ns < N; Ns *= 2) {
+            glBindFramebuffer(GL_FRAMEBUFFER, pingFBO[1 - src]);
+            for (int t = 0; t < 3; ++t) {
+                glActiveTexture(GL_TEXTURE0 + t);
+                glBindTexture(GL_TEXTURE_2D, pingTex[src][t]);
+            }
+            fftShader->setInt(fftStageLoc, Ns);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            src = 1 - src;
+        }
+    }
+
+    // znak (-1)^(x+z), lambda, normalne -> tekstury wynikowe
+    glBindFramebuffer(GL_FRAMEBUFFER, resolveFBO);
+    resolveShader->use();
+    for (int t = 0; t < 3; ++t) {
+        glActiveTexture(GL_TEXTURE0 + t);
+        glBindTexture(GL_TEXTURE_2D, pingTex[src][t]);
+    }
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (depthTest) glEnable(GL_DEPTH_TEST);
+    if (blend) glEnable(GL_BLEND);
+}
+
+float OceanFFT::validateGPU(float time)
+{
+    int N = spectrumParams.resolution;
+    update(time);
+
+    std::vector<glm::vec4> gpu(N * N);
+    glBindTexture(GL_TEXTURE_2D, displacementTex);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, &gpu[0]);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    std::vector<glm::vec4> cpu, cpuNormals;
+    computeCPU(time, cpu, cpuNormals);
+
+    float maxValue = 1e-6f, maxError = 0.0f;
+    for (int i = 0; i < N * N; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            maxValue = std::max(maxValue, std::fabs(cpu[i][c]));
+            maxError = std::max(maxError, std::fabs(cpu[i][c] - gpu[i][c]));
+        }
+    }
+    return maxError / maxValue;
+}
+
+void OceanFFT::Delete()
+{
+    if (spectrumShader) { spectrumShader->Delete(); delete spectrumShader; spectrumShader = nullptr; }
+    if (fftShader) { fftShader->Delete(); delete fftShader; fftShader = nullptr; }
+    if (resolveShader) { resolveShader->Delete(); delete resolveShader; resolveShader = nullptr; }
+    glDeleteTextures(1, &h0Tex);
+    glDeleteTextures(6, &pingTex[0][0]);
+    glDeleteTextures(1, &displacementTex);
+    glDeleteTextures(1, &normalTex);
+    glDeleteFramebuffers(2, pingFBO);
+    glDeleteFramebuffers(1, &resolveFBO);
+    glDeleteVertexArrays(1, &emptyVAO);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef OCEAN_FFT_CLASS_H
+#define OCEAN_FFT_CLASS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <complex>
+#include <vector>
+
+#include "shaderClass.h"
+
+// Parametry widma Phillipsa (Tessendorf, "Simulating Ocean Water").
+struct OceanSpectrumParams
+{
+    int          resolution = 128;                    // N, potega dwojki
+    float        patchSize = 64.0f;                   // L - bok kafla w jednostkach swiata
+    glm::vec2    wind = glm::vec2(10.0f, 5.0f);       // predkosc wiatru [m/s]
+    float        amplitude = 0.00001f;                // A
+    float        choppiness = 1.0f;                   // lambda dla przesuniec poziomych
+    unsigned int seed = 1337;
+};
+
+// Ocean FFT: widmo h0(k) liczone raz, co klatke h(k,t) i odwrotna FFT
+// (Stockham radix-2, przebiegi fragment shadera ping-pong), wynik w
+// teksturach przesuniec i normalnych probkowanych w ocean.vert.
+// Ta sama FFT jest zaimplementowana na CPU jako referencja do walidacji.
+class OceanFFT
+{
+public:
+    explicit OceanFFT(const OceanSpectrumParams& params = OceanSpectrumParams());
+
+    const OceanSpectrumParams& params() const { return spectrumParams; }
+
+    // --- CPU ---
+    // displacement: (dx, h, dz, 0), normals: (nx, ny, nz, 0); N*N elementow, wiersze po z
+    void computeCPU(float time, std::vector<glm::vec4>& displacement, std::vector<glm::vec4>& normals) const;
+
+    // odwrotna DFT w miejscu (bez normalizacji), n = potega dwojki; ta sama kolejnosc co shader
+    static void inverseFFT(std::vector<std::complex<float>>& data, std::vector<std::complex<float>>& scratch);
+    // porownanie inverseFFT z naiwna DFT, zwraca maks. blad
+    static float selfTest(int n);
+
+    // --- GPU ---
+    void initGPU();
+    void update(float time);
+    // odczyt tekstury przesuniec i porownanie z computeCPU; zwraca maks. blad wzgledny
+    float validateGPU(float time);
+    void Delete();
+
+    GLuint displacementTexture() const { return displacementTex; }
+    GLuint normalTexture() const { return normalTex; }
+
+private:
+    OceanSpectrumParams spectrumParams;
+    // h0(k) oraz conj(h0(-k)) dla kazdego k
+    std::vector<std::complex<float>> h0;
+    std::vector<std::complex<float>> h0MinusConj;
+
+    Shader* spectrumShader = nullptr;
+    Shader* fftShader = nullptr;
+    Shader* resolveShader = nullptr;
+    GLuint h0Tex = 0;
+    GLuint pingTex[2][3] = {};
+    GLuint pingFBO[2] = {};
+    GLuint displacementTex = 0;
+    GLuint normalTex = 0;
+    GLuint resolveFBO = 0;
+    GLuint emptyVAO = 0;
+
+    UniformHandle spectrumTimeLoc, fftStageLoc, fftVerticalLoc;
+
+    void generateSpectrum();
+    float omega(int n, int m) const;
+    glm::vec2 waveVector(int n, int m) const;
+};
+
+#endif
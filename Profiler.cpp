@@ -0,0 +1,193 @@
+#include "Profiler.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+void RollingSamples::add(float ms)
+{
+    int capacity = static_cast<int>(samples.size());
+    samples[head] = ms;
+    head = (head + 1) % capacity;
+    count = std::min(count + 1, capacity);
+}
+
+ProfilerStats RollingSamples::stats() const
+{
+    ProfilerStats s;
+    s.samples = count;
+    if (count == 0) return s;
+
+    std::vector<float> sorted(samples.begin(), samples.begin() + count);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (float ms : sorted) sum += ms;
+    //percentyl p: najmniejsza probka, od ktorej co najwyzej (100 - p)% jest wolniejszych
+    auto percentile = [&](int p) { return sorted[std::min(count - 1, (count * p) / 100)]; };
+
+    s.min = sorted.front();
+    s.max = sorted.back();
+    s.avg = static_cast<float>(sum / count);
+    s.p50 = percentile(50);
+    s.p90 = percentile(90);
+    s.p99 = percentile(99);
+    s.last = samples[(head + samples.size() - 1) % samples.size()];
+    return s;
+}
+
+static float millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+Profiler::Profiler(bool gpuTiming, int history)
+    : frameTimes(history), gpuTiming(gpuTiming), history(history)
+{
+    stageList.reserve(16);
+}
+
+void Profiler::reset()
+{
+    frameTimes.clear();
+    for (Stage& stage : stageList) {
+        stage.cpu.clear();
+        stage.gpu.clear();
+        //wyniki GPU sprzed resetu nie trafiaja do nowych statystyk
+        std::fill(stage.pending, stage.pending + PROFILER_QUERY_FRAMES, false);
+        std::fill(stage.timestampPending, stage.timestampPending + PROFILER_QUERY_FRAMES, false);
+    }
+}
+
+static bool queryReady(GLuint query)
+{
+    GLint available = 0;
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    return available != 0;
+}
+
+void Profiler::beginFrame()
+{
+    frameStart = std::chrono::steady_clock::now();
+    if (!gpuTiming) return;
+
+    //zegar GPU przeliczany na zegar sladu raz na sesje zapisu
+    bool tracing = traceEnabled();
+    if (tracing && !gpuClockCalibrated) {
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        gpuClockOffset = traceNow() - gpuNow / 1000;
+        gpuClockCalibrated = true;
+    }
+    if (!tracing) gpuClockCalibrated = false;
+
+    //ten slot byl uzyty PROFILER_QUERY_FRAMES klatek temu
+    int slot = frame % PROFILER_QUERY_FRAMES;
+    for (Stage& stage : stageList) {
+        bool hadTimestamp = stage.timestampPending[slot];
+        stage.timestampPending[slot] = false;
+        if (!stage.pending[slot]) continue;
+        stage.pending[slot] = false;
+        //niegotowy wynik przepada - lepsza dziura w statystyce niz czekanie na GPU
+        if (!queryReady(stage.queries[slot])) continue;
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(stage.queries[slot], GL_QUERY_RESULT, &nanoseconds);
+        stage.gpu.add(static_cast<float>(nanoseconds * 1e-6));
+
+        if (hadTimestamp && tracing && queryReady(stage.timestamps[slot])) {
+            GLuint64 gpuStart = 0;
+            glGetQueryObjectui64v(stage.timestamps[slot], GL_QUERY_RESULT, &gpuStart);
+            traceGpuSpan(stage.name, (int64_t)(gpuStart / 1000) + gpuClockOffset, (int64_t)(nanoseconds / 1000));
+        }
+    }
+}
+
+void Profiler::endFrame()
+{
+    if (traceEnabled())
+        traceSpan("frame", "frame", traceTimestamp(frameStart), traceNow() - traceTimestamp(frameStart));
+    frameTimes.add(millisecondsSince(frameStart));
+    frame++;
+}
+
+int Profiler::stageIndex(const char* name)
+{
+    for (size_t i = 0; i < stageList.size(); ++i) {
+        if (stageList[i].name == name || strcmp(stageList[i].name, name) == 0)
+            return static_cast<int>(i);
+    }
+    Stage stage;
+    stage.name = name;
+    stage.cpu = RollingSamples(history);
+    stage.gpu = RollingSamples(history);
+    stageList.push_back(stage);
+    return static_cast<int>(stageList.size() - 1);
+}
+
+int Profiler::begin(const char* name, bool gpu)
+{
+    int index = stageIndex(name);
+    Stage& stage = stageList[index];
+    stage.cpuStart = std::chrono::steady_clock::now();
+    stage.gpuActive = gpu && gpuTiming && !gpuBusy;
+    if (stage.gpuActive) {
+        int slot = frame % PROFILER_QUERY_FRAMES;
+        if (stage.queries[slot] == 0) glGenQueries(1, &stage.queries[slot]);
+        if (traceEnabled()) {
+            if (stage.timestamps[slot] == 0) glGenQueries(1, &stage.timestamps[slot]);
+            glQueryCounter(stage.timestamps[slot], GL_TIMESTAMP);
+            stage.timestampPending[slot] = true;
+        }
+        glBeginQuery(GL_TIME_ELAPSED, stage.queries[slot]);
+        gpuBusy = true;
+    }
+    return index;
+}
+
+void Profiler::end(int index)
+{
+    Stage& stage = stageList[index];
+    if (stage.gpuActive) {
+        glEndQuery(GL_TIME_ELAPSED);
+        stage.pending[frame % PROFILER_QUERY_FRAMES] = true;
+        stage.gpuActive = false;
+        gpuBusy = false;
+    }
+    float milliseconds = millisecondsSince(stage.cpuStart);
+    stage.cpu.add(milliseconds);
+    if (traceEnabled())
+        traceSpan(stage.name, "frame", traceTimestamp(stage.cpuStart), (int64_t)(milliseconds * 1000.0f));
+}
+
+void Profiler::report(std::ostream& out) const
+{
+    ProfilerStats total = frameTimes.stats();
+    out << "INFO: Profiler - " << total.samples << " ostatnich klatek, ms (min / avg / p99)" << std::endl;
+    out << std::fixed << std::setprecision(3);
+    out << "  " << std::left << std::setw(14) << "klatka" << std::right
+        << " CPU " << std::setw(8) << total.min << std::setw(8) << total.avg << std::setw(8) << total.p99 << std::endl;
+    for (const Stage& stage : stageList) {
+        ProfilerStats cpu = stage.cpu.stats();
+        ProfilerStats gpu = stage.gpu.stats();
+        out << "  " << std::left << std::setw(14) << stage.name << std::right
+            << " CPU " << std::setw(8) << cpu.min << std::setw(8) << cpu.avg << std::setw(8) << cpu.p99;
+        if (gpu.samples > 0)
+            out << "   GPU " << std::setw(8) << gpu.min << std::setw(8) << gpu.avg << std::setw(8) << gpu.p99;
+        out << std::endl;
+    }
+    out << std::defaultfloat;
+}
+
+void Profiler::Delete()
+{
+    for (Stage& stage : stageList) {
+        for (GLuint& query : stage.queries) {
+            if (query) glDeleteQueries(1, &query);
+            query = 0;
+        }
+        for (GLuint& query : stage.timestamps) {
+            if (query) glDeleteQueries(1, &query);
+            query = 0;
+        }
+    }
+}
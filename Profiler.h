@@ -0,0 +1,121 @@
+#pragma once
+#ifndef PROFILER_CLASS_H
+#define PROFILER_CLASS_H
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Domyslna liczba ostatnich klatek w statystykach
+const int PROFILER_HISTORY = 240;
+// Zapytania GPU w pierscieniu klatek: wynik czytany PROFILER_QUERY_FRAMES
+// klatek pozniej, kiedy GPU zwykle juz skonczylo - bez czekania CPU na GPU
+const int PROFILER_QUERY_FRAMES = 4;
+
+struct ProfilerStats
+{
+    float min = 0.0f;
+    float avg = 0.0f;
+    float p50 = 0.0f;
+    float p90 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+    float last = 0.0f;
+    int samples = 0;
+};
+
+// Ostatnie `capacity` probek (ms) jednego pomiaru
+class RollingSamples
+{
+public:
+    explicit RollingSamples(int capacity = PROFILER_HISTORY) : samples(capacity, 0.0f) {}
+
+    void add(float ms);
+    void clear() { head = count = 0; }
+    ProfilerStats stats() const;
+
+private:
+    std::vector<float> samples;
+    int head = 0;
+    int count = 0;
+};
+
+// Profiler klatki: nazwane etapy mierzone na CPU (zegar) i na GPU
+// (GL_TIME_ELAPSED). Etapy GPU nie moga sie zagniezdzac - zagniezdzony
+// etap mierzy tylko CPU. Nazwy musza zyc przez caly czas dzialania
+// (literaly), etapy sa rozpoznawane po wskazniku albo tresci.
+// Przy wlaczonym sladzie (Trace.h) etapy i klatki trafiaja tez na os czasu.
+class Profiler
+{
+public:
+    struct Stage
+    {
+        const char* name;
+        RollingSamples cpu;
+        RollingSamples gpu;
+        GLuint queries[PROFILER_QUERY_FRAMES] = {};
+        bool pending[PROFILER_QUERY_FRAMES] = {};
+        // GL_TIMESTAMP poczatku etapu - tylko przy zapisie sladu (Trace.h)
+        GLuint timestamps[PROFILER_QUERY_FRAMES] = {};
+        bool timestampPending[PROFILER_QUERY_FRAMES] = {};
+        std::chrono::steady_clock::time_point cpuStart;
+        bool gpuActive = false;
+    };
+
+    // gpuTiming = false: tylko czasy CPU (np. bez kontekstu GL);
+    // history: liczba klatek w statystykach (benchmark - wszystkie mierzone)
+    explicit Profiler(bool gpuTiming = true, int history = PROFILER_HISTORY);
+
+    // zbiera gotowe wyniki GPU sprzed PROFILER_QUERY_FRAMES klatek
+    void beginFrame();
+    void endFrame();
+    // zeruje statystyki (np. po rozgrzewce benchmarku), etapy zostaja
+    void reset();
+
+    int begin(const char* name, bool gpu = true);
+    void end(int stage);
+
+    const std::vector<Stage>& stages() const { return stageList; }
+    // czas CPU calej klatki (beginFrame -> endFrame)
+    ProfilerStats frameStats() const { return frameTimes.stats(); }
+    int frameCount() const { return frame; }
+
+    // tabela min/avg/p99 wszystkich etapow
+    void report(std::ostream& out) const;
+
+    void Delete();
+
+private:
+    std::vector<Stage> stageList;
+    RollingSamples frameTimes;
+    std::chrono::steady_clock::time_point frameStart;
+    bool gpuTiming;
+    int history;
+    bool gpuBusy = false;   // trwa etap z zapytaniem GL_TIME_ELAPSED
+    int64_t gpuClockOffset = 0;     // zegar sladu - czas GL_TIMESTAMP (us)
+    bool gpuClockCalibrated = false;
+    int frame = 0;
+
+    int stageIndex(const char* name);
+};
+
+// Etap profilera na czas zycia obiektu
+class ProfileScope
+{
+public:
+    ProfileScope(Profiler& profiler, const char* name, bool gpu = true)
+        : profiler(profiler), stage(profiler.begin(name, gpu)) {}
+    ~ProfileScope() { profiler.end(stage); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler& profiler;
+    int stage;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include "Random.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RANDOM_SSE2 1
+#include <emmintrin.h>
+#else
+#define RANDOM_SSE2 0
+#endif
+
+static inline uint32_t rotl(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+//splitmix64 - rozprowadza ziarno po calym stanie (stan nie moze byc zerowy)
+static uint64_t splitmix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+Random::Random(uint64_t seed)
+{
+    uint64_t a = splitmix64(seed);
+    uint64_t b = splitmix64(seed);
+    s[0] = (uint32_t)a; s[1] = (uint32_t)(a >> 32);
+    s[2] = (uint32_t)b; s[3] = (uint32_t)(b >> 32);
+}
+
+uint32_t Random::next()
+{
+    const uint32_t result = s[0] + s[3];
+    const uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+    return result;
+}
+
+int Random::rangeInt(int lo, int hi)
+{
+    uint32_t span = (uint32_t)(hi - lo) + 1u;
+    //mnozenie zamiast modulo - bez zauwazalnego skrzywienia dla malych zakresow
+    return lo + (int)(((uint64_t)next() * span) >> 32);
+}
+
+void Random::jump()
+{
+    static const uint32_t JUMP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+    uint32_t j0 = 0, j1 = 0, j2 = 0, j3 = 0;
+    for (int i = 0; i < 4; ++i) {
+        for (int b = 0; b < 32; ++b) {
+            if (JUMP[i] & (1u << b)) {
+                j0 ^= s[0]; j1 ^= s[1]; j2 ^= s[2]; j3 ^= s[3];
+            }
+            next();
+        }
+    }
+    s[0] = j0; s[1] = j1; s[2] = j2; s[3] = j3;
+}
+
+void Random::longJump()
+{
+    static const uint32_t LONG_JUMP[] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+    uint32_t j0 = 0, j1 = 0, j2 = 0, j3 = 0;
+    for (int i = 0; i < 4; ++i) {
+        for (int b = 0; b < 32; ++b) {
+            if (LONG_JUMP[i] & (1u << b)) {
+                j0 ^= s[0]; j1 ^= s[1]; j2 ^= s[2]; j3 ^= s[3];
+            }
+            next();
+        }
+    }
+    s[0] = j0; s[1] = j1; s[2] = j2; s[3] = j3;
+}
+
+Random Random::stream(int index) const
+{
+    Random r = *this;
+    for (int i = 0; i <= index; ++i)
+        r.jump();
+    return r;
+}
+
+void Random::fillFloats(float* out, int n)
+{
+    for (int i = 0; i < n; ++i)
+        out[i] = nextFloat();
+}
+
+RandomBatch::RandomBatch(const Random& source)
+{
+    Random r = source;
+    for (int lane = 0; lane < 4; ++lane) {
+        r.longJump();
+        s0[lane] = r.s[0]; s1[lane] = r.s[1]; s2[lane] = r.s[2]; s3[lane] = r.s[3];
+    }
+}
+
+void RandomBatch::fillFloats(float* out, int n)
+{
+    int i = 0;
+#if RANDOM_SSE2
+    __m128i a = _mm_load_si128((const __m128i*)s0);
+    __m128i b = _mm_load_si128((const __m128i*)s1);
+    __m128i c = _mm_load_si128((const __m128i*)s2);
+    __m128i d = _mm_load_si128((const __m128i*)s3);
+    const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+    for (; i + 4 <= n; i += 4) {
+        __m128i result = _mm_add_epi32(a, d);
+        __m128i t = _mm_slli_epi32(b, 9);
+        c = _mm_xor_si128(c, a);
+        d = _mm_xor_si128(d, b);
+        b = _mm_xor_si128(b, c);
+        a = _mm_xor_si128(a, d);
+        c = _mm_xor_si128(c, t);
+        d = _mm_or_si128(_mm_slli_epi32(d, 11), _mm_srli_epi32(d, 21));
+        __m128 f = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), scale);
+        _mm_storeu_ps(out + i, f);
+    }
+    _mm_store_si128((__m128i*)s0, a);
+    _mm_store_si128((__m128i*)s1, b);
+    _mm_store_si128((__m128i*)s2, c);
+    _mm_store_si128((__m128i*)s3, d);
+#endif
+    for (; i < n; ++i) {
+        int lane = i & 3;
+        const uint32_t result = s0[lane] + s3[lane];
+        const uint32_t t = s1[lane] << 9;
+        s2[lane] ^= s0[lane];
+        s3[lane] ^= s1[lane];
+        s1[lane] ^= s2[lane];
+        s0[lane] ^= s3[lane];
+        s2[lane] ^= t;
+        s3[lane] = rotl(s3[lane], 11);
+        out[i] = (result >> 8) * (1.0f / 16777216.0f);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#ifndef RANDOM_CLASS_H
+#define RANDOM_CLASS_H
+
+#include <cstdint>
+
+// Generator xoshiro128+ (Blackman, Vigna): 128 bitow stanu, okres 2^128 - 1.
+// Zamiast wspolnego rand(): kazdy podsystem/zadanie ma wlasny strumien,
+// wiec wynik zalezy tylko od ziarna, a nie od kolejnosci watkow.
+// Strumienie to ten sam ciag przesuniety o wielokrotnosci 2^64 (jump()).
+class Random
+{
+public:
+    explicit Random(uint64_t seed = 1);
+
+    uint32_t next();
+    // [0, 1), 24 bity mantysy
+    float nextFloat() { return (next() >> 8) * (1.0f / 16777216.0f); }
+    // [lo, hi)
+    float range(float lo, float hi) { return lo + nextFloat() * (hi - lo); }
+    // [lo, hi] wlacznie
+    int rangeInt(int lo, int hi);
+
+    // przeskok o 2^64 krokow
+    void jump();
+    // przeskok o 2^96 krokow - rozlaczny ze wszystkimi strumieniami stream()
+    void longJump();
+    // niezalezny strumien nr index (0, 1, 2, ...) z tego samego ziarna
+    Random stream(int index) const;
+
+    // n liczb [0, 1) po kolei (to samo co n razy nextFloat)
+    void fillFloats(float* out, int n);
+
+private:
+    friend class RandomBatch;
+    uint32_t s[4];
+};
+
+// Cztery strumienie xoshiro128+ liczone rownolegle (SSE2), stan w ukladzie
+// SoA - jedna instrukcja przesuwa wszystkie cztery generatory.
+class RandomBatch
+{
+public:
+    // pas k = zrodlo po (k + 1) longJump(); zrodlo sie nie zmienia
+    explicit RandomBatch(const Random& source);
+
+    // n liczb [0, 1); kolejnosc: naprzemiennie z czterech strumieni
+    void fillFloats(float* out, int n);
+
+private:
+    alignas(16) uint32_t s0[4];
+    alignas(16) uint32_t s1[4];
+    alignas(16) uint32_t s2[4];
+    alignas(16) uint32_t s3[4];
+};
+
+#endif
@@ -0,0 +1,21 @@
+#pragma once
+#ifndef SCENE_CONFIG_CLASS_H
+#define SCENE_CONFIG_CLASS_H
+
+// Rozmiary sceny. Domyslne wartosci to dotychczasowa scena; --sweep
+// uruchamia program z innymi (--fish-groups, --plants-per-type, ...).
+struct SceneConfig
+{
+    int fishGroupsPerType = 60;     // lawice na gatunek (3 gatunki)
+    int fishGroupMin = 8;           // rozmiar lawicy
+    int fishGroupMax = 14;
+    int plantsPerType = 400;        // 4 typy roslin
+    int bubbles = 10;
+    int groundResolution = 150;     // siatka dna n x n
+    int oceanGridHalf = 32;         // OceanClipmapParams::gridHalf (siatka poziomu 2n+1)
+
+    // srednia liczba ryb w lawicy - do przeliczania docelowej liczby ryb na lawice
+    float averageGroupSize() const { return 0.5f * (fishGroupMin + fishGroupMax); }
+};
+
+#endif
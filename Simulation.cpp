@@ -0,0 +1,123 @@
+#include "Simulation.h"
+#include "Trace.h"
+
+#include <chrono>
+#include <glm/gtc/matrix_transform.hpp>
+
+Simulation::Simulation(JobSystem& jobs, FishSystem& fish, std::vector<BubbleInstance>& bubbles, const SimulationSettings& settings,
+    const Random& random)
+    : jobs(jobs), fish(fish), bubbles(bubbles), settings(settings), bubbleRandom(random)
+{
+    //stan poczatkowy widoczny od pierwszej klatki
+    writeSnapshot(snapshots[0]);
+    writeSnapshot(snapshots[1]);
+}
+
+Simulation::~Simulation()
+{
+    finish();
+}
+
+void Simulation::beginFrame(float frameTime, float cameraZ)
+{
+    jobs.wait(stepCounter);
+    //po wait() krok juz nie pisze stepMs - kopia tylko dla watku glownego
+    lastCompletedStepMs = stepMs;
+    if (backReady) {
+        front = 1 - front;
+        backReady = false;
+    }
+
+    accumulator += frameTime;
+    int steps = static_cast<int>(accumulator / settings.timeStep);
+    if (steps > settings.maxStepsPerFrame) {
+        steps = settings.maxStepsPerFrame;
+        accumulator = 0.0f;
+    }
+    else {
+        accumulator -= steps * settings.timeStep;
+    }
+    if (steps == 0) return;
+
+    backReady = true;
+    jobs.submit([this, steps, cameraZ] { runSteps(steps, cameraZ); }, &stepCounter);
+}
+
+void Simulation::finish()
+{
+    jobs.wait(stepCounter);
+}
+
+void Simulation::runSteps(int steps, float cameraZ)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i)
+        step(cameraZ);
+    writeSnapshot(snapshots[1 - front]);
+    stepMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Simulation::step(float cameraZ)
+{
+    TraceScope trace("simulation step", "simulation");
+    const float dt = settings.timeStep;
+
+    //babelki niezalezne od ryb - osobne zadanie w tle
+    JobCounter bubblesDone;
+    jobs.submit([this, dt] { stepBubbles(dt); }, &bubblesDone);
+
+    //lawice: siatka gatunku na tym watku, sterowanie w paczkach na calej puli
+    for (int s = 0; s < fish.speciesCount(); ++s) {
+        fish.prepareSteer(s);
+        jobs.parallelFor(0, fish.speciesSize(s), settings.steerChunk,
+            [this, dt](int begin, int end) { fish.steerSlots(begin, end, dt); });
+    }
+    fish.update(settings.fishSpeed * dt * 60.0f, cameraZ);
+
+    jobs.wait(bubblesDone);
+    stepsDone++;
+}
+
+void Simulation::stepBubbles(float dt)
+{
+    TraceScope trace("bubbles step", "simulation");
+    for (BubbleInstance& b : bubbles) {
+        b.position.y += b.speed * dt * 60.0f;
+        if (b.position.y > settings.maxBubbleHeight) {
+            Random& r = bubbleRandom;
+            //kolejnosc losowan jawna - argumenty konstruktora nie maja ustalonej kolejnosci
+            float x = r.range(-150.0f, 150.0f);
+            float y = r.range(-20.0f, -10.0f);
+            float z = r.range(-150.0f, 150.0f);
+            b.position = glm::vec3(x, y, z);
+            b.speed = r.range(0.1f, 0.2f);
+            b.scale = r.range(0.0001f, 0.1001f);
+        }
+    }
+}
+
+void Simulation::writeSnapshot(SimulationSnapshot& out) const
+{
+    TraceScope trace("snapshot", "simulation");
+    out.fish.resize(fish.size());
+    out.speciesFirst.resize(fish.speciesCount());
+    out.speciesCount.resize(fish.speciesCount());
+    for (int s = 0; s < fish.speciesCount(); ++s) {
+        out.speciesFirst[s] = fish.speciesFirst(s);
+        out.speciesCount[s] = fish.speciesSize(s);
+        if (fish.speciesSize(s) > 0)
+            fish.writeInstances(s, &out.fish[fish.speciesFirst(s)]);
+    }
+
+    out.bubbleModels.resize(bubbles.size());
+    for (size_t i = 0; i < bubbles.size(); ++i) {
+        const BubbleInstance& b = bubbles[i];
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, glm::vec3(0.0f, -1.0f, 0.0f));
+        model = glm::scale(model, glm::vec3(b.scale));
+        model = glm::rotate(model, glm::radians(180.0f), glm::vec3(1, 0, 0));
+        model = glm::translate(model, b.position);
+        out.bubbleModels[i] = model;
+    }
+    out.step = stepsDone;
+}
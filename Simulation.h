@@ -0,0 +1,85 @@
+#pragma once
+#ifndef SIMULATION_CLASS_H
+#define SIMULATION_CLASS_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "FishSystem.h"
+#include "JobSystem.h"
+#include "Random.h"
+
+//babelki
+struct BubbleInstance {
+    glm::vec3 position;
+    float     speed;
+    float     scale;
+};
+
+// Niezmienny wynik kroku symulacji - jedyne dane czytane przez render.
+struct SimulationSnapshot
+{
+    std::vector<FishInstanceGPU> fish;      //gatunki w zakresach jak w FishSystem
+    std::vector<int> speciesFirst;
+    std::vector<int> speciesCount;
+    std::vector<glm::mat4> bubbleModels;
+    long long step = 0;                     //liczba wykonanych krokow
+};
+
+struct SimulationSettings
+{
+    float timeStep = 1.0f / 60.0f;
+    int   maxStepsPerFrame = 4;         //dogonienie po dlugiej klatce, reszta czasu przepada
+    float fishSpeed = 0.1f;             //globalna szybkosc ryb
+    float maxBubbleHeight = -0.1f;
+    int   steerChunk = 2048;            //ryb na zadanie sterowania lawica
+};
+
+// Symulacja o stalym kroku na puli watkow, podwojnie buforowana: klatka N
+// renderuje snapshot kroku zleconego w klatce N-1, a w tym czasie liczy sie
+// krok N. Ryby i babelki naleza do symulacji - miedzy beginFrame() a
+// kolejnym beginFrame()/finish() watek glowny nie moze ich dotykac.
+class Simulation
+{
+public:
+    // random: strumien dla respawnu babelkow
+    Simulation(JobSystem& jobs, FishSystem& fish, std::vector<BubbleInstance>& bubbles,
+        const SimulationSettings& settings = SimulationSettings(), const Random& random = Random());
+    ~Simulation();
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    // czeka na krok z poprzedniej klatki, publikuje jego snapshot i zleca
+    // tyle krokow, ile miesci sie w zgromadzonym czasie
+    void beginFrame(float frameTime, float cameraZ);
+    // czeka na trwajacy krok (np. przed zamknieciem)
+    void finish();
+
+    const SimulationSnapshot& snapshot() const { return snapshots[front]; }
+    // czas ostatniego zakonczonego kroku [ms], zapisany w beginFrame po wait()
+    double lastStepMs() const { return lastCompletedStepMs; }
+
+private:
+    JobSystem& jobs;
+    FishSystem& fish;
+    std::vector<BubbleInstance>& bubbles;
+    SimulationSettings settings;
+    Random bubbleRandom;
+
+    SimulationSnapshot snapshots[2];
+    int front = 0;
+    bool backReady = false;
+    JobCounter stepCounter;
+    float accumulator = 0.0f;
+    long long stepsDone = 0;
+    double stepMs = 0.0;
+    double lastCompletedStepMs = 0.0;
+
+    // watek roboczy
+    void runSteps(int steps, float cameraZ);
+    void step(float cameraZ);
+    void stepBubbles(float dt);
+    void writeSnapshot(SimulationSnapshot& out) const;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "SpatialGrid.h"
+
+bool SpatialGrid::rowsDisjoint(unsigned int buckets)
+{
+    unsigned int rows[9];
+    int n = 0;
+    for (int dz = -1; dz <= 1; ++dz)
+        for (int dy = -1; dy <= 1; ++dy)
+            rows[n++] = ((unsigned int)dy * ROW_Y + (unsigned int)dz * ROW_Z) & (buckets - 1);
+    for (int a = 0; a < 9; ++a) {
+        for (int b = a + 1; b < 9; ++b) {
+            unsigned int d = (rows[a] - rows[b]) & (buckets - 1);
+            if (d < 3 || d > buckets - 3) return false;
+        }
+    }
+    return true;
+}
+
+void SpatialGrid::build(const float* x, const float* y, const float* z, int first, int count, float cellSize)
+{
+    invCellSize = 1.0f / cellSize;
+
+    //co najmniej 2 kubelki na punkt - malo kolizji haszu
+    unsigned int buckets = 64;
+    while (buckets < (unsigned int)count * 2 || !rowsDisjoint(buckets)) buckets <<= 1;
+    bucketMask = buckets - 1;
+
+    cellStart.assign(buckets + 1, 0);
+    pointBucket.resize(count);
+    order.resize(count);
+    sortedX.resize(count); sortedY.resize(count); sortedZ.resize(count);
+
+    //zliczanie
+    for (int i = 0; i < count; ++i) {
+        int p = first + i;
+        unsigned int b = bucket(cellCoord(x[p]), cellCoord(y[p]), cellCoord(z[p]));
+        pointBucket[i] = b;
+        cellStart[b + 1]++;
+    }
+    //sumy prefiksowe
+    for (unsigned int b = 0; b < buckets; ++b)
+        cellStart[b + 1] += cellStart[b];
+
+    //rozklad do slotow (cellStart[b] sluzy chwilowo jako kursor)
+    for (int i = 0; i < count; ++i) {
+        int slot = cellStart[pointBucket[i]]++;
+        int p = first + i;
+        order[slot] = p;
+        sortedX[slot] = x[p]; sortedY[slot] = y[p]; sortedZ[slot] = z[p];
+    }
+    //przywrocenie poczatkow kubelkow
+    for (unsigned int b = buckets; b > 0; --b)
+        cellStart[b] = cellStart[b - 1];
+    cellStart[0] = 0;
+}
+
+int SpatialGrid::neighbourRanges(int cx, int cy, int cz, SlotRange out[27]) const
+{
+    int n = 0;
+    for (int dz = -1; dz <= 1; ++dz) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            unsigned int left = bucket(cx - 1, cy + dy, cz + dz);
+            if (left + 2 <= bucketMask) {
+                out[n++] = { cellStart[left], cellStart[left + 3] };
+            }
+            else {
+                //wiersz przechodzi przez koniec tablicy - trzy osobne kubelki
+                for (unsigned int k = 0; k < 3; ++k) {
+                    unsigned int b = (left + k) & bucketMask;
+                    out[n++] = { cellStart[b], cellStart[b + 1] };
+                }
+            }
+        }
+    }
+    return n;
+}
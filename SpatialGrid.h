@@ -0,0 +1,54 @@
+#pragma once
+#ifndef SPATIAL_GRID_CLASS_H
+#define SPATIAL_GRID_CLASS_H
+
+#include <cmath>
+#include <vector>
+
+// Jednorodna siatka 3D z haszowaniem komorek, budowana od zera co klatke
+// sortowaniem przez zliczanie. Hasz jest liniowy i w x ma krok 1, wiec trzy
+// sasiednie komorki w x to trzy kolejne kubelki: 27 komorek wokol punktu
+// to 9 ciaglych zakresow slotow (sortedX/Y/Z).
+class SpatialGrid
+{
+public:
+    // zakres slotow [begin, end)
+    struct SlotRange
+    {
+        int begin;
+        int end;
+    };
+
+    // punkty [first, first + count) tablic x/y/z
+    void build(const float* x, const float* y, const float* z, int first, int count, float cellSize);
+
+    int cellCoord(float v) const { return static_cast<int>(std::floor(v * invCellSize)); }
+    unsigned int bucket(int cx, int cy, int cz) const
+    {
+        return ((unsigned int)cx + (unsigned int)cy * ROW_Y + (unsigned int)cz * ROW_Z) & bucketMask;
+    }
+
+    // zakresy slotow 27 komorek wokol (cx, cy, cz); zwraca ich liczbe (9..27)
+    int neighbourRanges(int cx, int cy, int cz, SlotRange out[27]) const;
+
+    int pointCount() const { return static_cast<int>(order.size()); }
+
+    // kubelek b zajmuje sloty [cellStart[b], cellStart[b + 1])
+    std::vector<int> cellStart;
+    // slot -> indeks punktu w tablicach wejsciowych
+    std::vector<int> order;
+    std::vector<float> sortedX, sortedY, sortedZ;
+
+private:
+    static const unsigned int ROW_Y = 19349663u;
+    static const unsigned int ROW_Z = 83492791u;
+
+    float invCellSize = 1.0f;
+    unsigned int bucketMask = 0;
+    std::vector<unsigned int> pointBucket;
+
+    // czy 9 wierszy (dy, dz) po 3 kubelki nie nachodzi na siebie
+    static bool rowsDisjoint(unsigned int buckets);
+};
+
+#endif
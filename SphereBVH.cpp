@@ -0,0 +1,97 @@
+#include "SphereBVH.h"
+
+#include <algorithm>
+
+void SphereBVH::build(const float* x, const float* y, const float* z, const float* radius, int count, int leaf)
+{
+    leafSize = std::max(1, leaf);
+    nodes.clear();
+    order.resize(count);
+    for (int i = 0; i < count; ++i) order[i] = i;
+
+    //kopie w kolejnosci wejsciowej; po podziale przestawiane wg order
+    sortedX.assign(x, x + count);
+    sortedY.assign(y, y + count);
+    sortedZ.assign(z, z + count);
+    sortedR.assign(radius, radius + count);
+    if (count == 0) return;
+
+    nodes.reserve(2 * (count / leafSize + 1));
+    buildNode(0, count);
+
+    std::vector<float> tmp(count);
+    std::vector<float>* arrays[4] = { &sortedX, &sortedY, &sortedZ, &sortedR };
+    for (std::vector<float>* a : arrays) {
+        for (int s = 0; s < count; ++s) tmp[s] = (*a)[order[s]];
+        a->swap(tmp);
+    }
+}
+
+int SphereBVH::buildNode(int first, int count)
+{
+    int index = static_cast<int>(nodes.size());
+    nodes.push_back(Node());
+
+    //granice sfer i granice samych srodkow (do wyboru osi)
+    glm::vec3 boundsMin(1e30f), boundsMax(-1e30f);
+    glm::vec3 centerMin(1e30f), centerMax(-1e30f);
+    for (int s = first; s < first + count; ++s) {
+        int i = order[s];
+        glm::vec3 c(sortedX[i], sortedY[i], sortedZ[i]);
+        boundsMin = glm::min(boundsMin, c - glm::vec3(sortedR[i]));
+        boundsMax = glm::max(boundsMax, c + glm::vec3(sortedR[i]));
+        centerMin = glm::min(centerMin, c);
+        centerMax = glm::max(centerMax, c);
+    }
+    nodes[index].boundsMin = boundsMin;
+    nodes[index].boundsMax = boundsMax;
+    nodes[index].first = first;
+    nodes[index].count = count;
+    nodes[index].right = -1;
+    if (count <= leafSize) return index;
+
+    glm::vec3 extent = centerMax - centerMin;
+    int axis = 0;
+    if (extent.y > extent[axis]) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+    const std::vector<float>& key = axis == 0 ? sortedX : (axis == 1 ? sortedY : sortedZ);
+
+    int half = count / 2;
+    std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+        [&key](int a, int b) { return key[a] < key[b]; });
+
+    buildNode(first, half);
+    int right = buildNode(first + half, count - half);
+    nodes[index].right = right;
+    return index;
+}
+
+int SphereBVH::cullFrustum(const Frustum& frustum, int* visible) const
+{
+    if (nodes.empty()) return 0;
+    int n = 0;
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        int index = stack[--top];
+        const Node& node = nodes[index];
+        FrustumOverlap overlap = classifyBox(frustum, node.boundsMin, node.boundsMax);
+        if (overlap == FRUSTUM_OUTSIDE) continue;
+        if (overlap == FRUSTUM_INSIDE) {
+            for (int s = node.first; s < node.first + node.count; ++s) visible[n++] = s;
+            continue;
+        }
+        if (node.right < 0) {
+            //lisc na brzegu - sfery testowane po 4 (SSE)
+            int k = cullSpheres(frustum, &sortedX[node.first], &sortedY[node.first], &sortedZ[node.first],
+                &sortedR[node.first], node.count, visible + n);
+            for (int j = 0; j < k; ++j) visible[n + j] += node.first;
+            n += k;
+            continue;
+        }
+        stack[top++] = node.right;
+        stack[top++] = index + 1;
+    }
+    return n;
+}
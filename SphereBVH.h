@@ -0,0 +1,47 @@
+#pragma once
+#ifndef SPHERE_BVH_CLASS_H
+#define SPHERE_BVH_CLASS_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Frustum.h"
+
+// Statyczne BVH (AABB) nad sferami obiektow, ktore sie nie ruszaja (rosliny
+// na dnie). Budowane raz, podzial po medianie najdluzszej osi. Wezly leza
+// w kolejnosci depth-first, a elementy sa przestawione tak, ze kazdy wezel
+// obejmuje ciagly zakres slotow [first, first + count) - wezel calkiem
+// w ostroslupie dopisuje caly zakres bez testow pojedynczych sfer.
+class SphereBVH
+{
+public:
+    struct Node
+    {
+        glm::vec3 boundsMin;
+        int first;
+        glm::vec3 boundsMax;
+        int count;
+        int right;   //indeks prawego dziecka (lewe to nastepny wezel), -1 dla liscia
+    };
+
+    // sfery [0, count); po budowie slot s odpowiada elementowi order[s]
+    void build(const float* x, const float* y, const float* z, const float* radius, int count, int leafSize = 16);
+
+    // sloty sfer przecinajacych ostroslup (miejsce na size() elementow); zwraca ich liczbe
+    int cullFrustum(const Frustum& frustum, int* visible) const;
+
+    int size() const { return static_cast<int>(order.size()); }
+    int nodeCount() const { return static_cast<int>(nodes.size()); }
+
+    std::vector<Node> nodes;
+    // slot -> indeks elementu w tablicach wejsciowych
+    std::vector<int> order;
+    std::vector<float> sortedX, sortedY, sortedZ, sortedR;
+
+private:
+    int leafSize = 16;
+
+    int buildNode(int first, int count);
+};
+
+#endif
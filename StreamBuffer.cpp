@@ -0,0 +1,50 @@
+#include "StreamBuffer.h"
+
+#include <cstddef>
+
+static const GLintptr STREAM_ALIGNMENT = 64;
+
+StreamBuffer::StreamBuffer(GLsizeiptr capacity)
+    : capacity(capacity)
+{
+    glGenBuffers(1, &ID);
+    orphan();
+}
+
+void StreamBuffer::orphan()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+    glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+    head = 0;
+}
+
+void* StreamBuffer::map(GLsizeiptr size, GLintptr& offset)
+{
+    if (size > capacity)
+    {
+        while (capacity < size) capacity *= 2;
+        orphan();
+    }
+    else if (head + size > capacity)
+    {
+        orphan();
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+    offset = head;
+    head = (head + size + STREAM_ALIGNMENT - 1) & ~(STREAM_ALIGNMENT - 1);
+    if (size == 0) return NULL;
+    return glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+void StreamBuffer::unmap()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+void StreamBuffer::Delete()
+{
+    glDeleteBuffers(1, &ID);
+}
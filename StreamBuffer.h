@@ -0,0 +1,31 @@
+#pragma once
+#ifndef STREAM_BUFFER_CLASS_H
+#define STREAM_BUFFER_CLASS_H
+
+#include <glad/glad.h>
+
+// Bufor strumieniowy na dane zmieniane co klatke (np. instancje ryb).
+// Zapis jest dopisywany za poprzednim (mapowanie UNSYNCHRONIZED), a po dojsciu
+// do konca bufor jest osierocany (glBufferData z NULL), wiec sterownik nie
+// musi czekac na GPU, ktore moze jeszcze czytac poprzednie klatki.
+class StreamBuffer
+{
+public:
+    GLuint ID = 0;
+
+    explicit StreamBuffer(GLsizeiptr capacity);
+
+    // mapuje `size` bajtow do zapisu; offset w buforze zwracany przez `offset`
+    void* map(GLsizeiptr size, GLintptr& offset);
+    void unmap();
+
+    void Delete();
+
+private:
+    GLsizeiptr capacity;
+    GLintptr head = 0;
+
+    void orphan();
+};
+
+#endif
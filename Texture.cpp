@@ -0,0 +1,103 @@
+#include "Texture.h"
+#include "Trace.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <iostream>
+
+ImageData::~ImageData()
+{
+    if (pixels) stbi_image_free(pixels);
+}
+
+ImageData::ImageData(ImageData&& other) noexcept
+    : path(std::move(other.path)), pixels(other.pixels), width(other.width), height(other.height), channels(other.channels)
+{
+    other.pixels = nullptr;
+}
+
+ImageData& ImageData::operator=(ImageData&& other) noexcept
+{
+    if (this != &other) {
+        if (pixels) stbi_image_free(pixels);
+        path = std::move(other.path);
+        pixels = other.pixels; width = other.width; height = other.height; channels = other.channels;
+        other.pixels = nullptr;
+    }
+    return *this;
+}
+
+bool decodeImage(const char* path, bool flipVertically, ImageData& out)
+{
+    // flaga flip w stb jest globalna - wersja _thread dziala per watek
+    stbi_set_flip_vertically_on_load_thread(flipVertically);
+    out.path = path;
+    out.pixels = stbi_load(path, &out.width, &out.height, &out.channels, 0);
+    return out.pixels != nullptr;
+}
+
+unsigned int uploadTexture(const ImageData& image) {
+    std::cout << "INFO: Texture " << image.path << " loaded with " << image.channels << " channel(s)." << std::endl;
+    if (!image.pixels) {
+        std::cerr << "ERROR: Texture failed to load at path: " << image.path << std::endl;
+        return 0;
+    }
+
+    GLenum format = GL_RGB;
+    if (image.channels == 1) format = GL_RED;
+    else if (image.channels == 3) format = GL_RGB;
+    else if (image.channels == 4) format = GL_RGBA;
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    std::cout << "INFO: Texture loaded: " << image.path << std::endl;
+    return textureID;
+}
+
+unsigned int uploadCubemap(const std::vector<ImageData>& faces) {
+    for (const ImageData& face : faces) {
+        if (!face.pixels) {
+            std::cerr << "ERROR: Cubemap texture failed to load at path: " << face.path << std::endl;
+            return 0;
+        }
+    }
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+    for (unsigned int i = 0; i < faces.size(); i++) {
+        GLenum format = GL_RGB;
+        if (faces[i].channels == 4) format = GL_RGBA;
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format, faces[i].width, faces[i].height, 0, format, GL_UNSIGNED_BYTE, faces[i].pixels);
+        std::cout << "INFO: Cubemap loaded: " << faces[i].path << std::endl;
+    }
+
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    return textureID;
+}
+
+unsigned int loadTexture(const char* path) {
+    TraceScope trace("loadTexture", "assets", path);
+    ImageData image;
+    decodeImage(path, true, image);
+    return uploadTexture(image);
+}
+
+unsigned int loadCubemap(std::vector<std::string> faces) {
+    std::vector<ImageData> images(faces.size());
+    for (size_t i = 0; i < faces.size(); i++)
+        decodeImage(faces[i].c_str(), false, images[i]);
+    return uploadCubemap(images);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#ifndef TEXTURE_CLASS_H
+#define TEXTURE_CLASS_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+// Zdekodowany obraz (stb_image) czekajacy na wyslanie do GL.
+struct ImageData
+{
+    std::string path;
+    unsigned char* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    ImageData() = default;
+    ~ImageData();
+    ImageData(const ImageData&) = delete;
+    ImageData& operator=(const ImageData&) = delete;
+    ImageData(ImageData&& other) noexcept;
+    ImageData& operator=(ImageData&& other) noexcept;
+};
+
+// dekodowanie bez GL - bezpieczne na watkach roboczych
+bool decodeImage(const char* path, bool flipVertically, ImageData& out);
+
+// wysylanie na GPU - tylko watek z kontekstem GL
+unsigned int uploadTexture(const ImageData& image);
+unsigned int uploadCubemap(const std::vector<ImageData>& faces);
+
+unsigned int loadTexture(const char* path);
+unsigned int loadCubemap(std::vector<std::string> faces);
+
+#endif
@@ -0,0 +1,159 @@
+#include "Trace.h"
+
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> traceActive{ false };
+
+namespace {
+
+struct TraceEvent
+{
+    char phase;             // 'X' przedzial, 'C' licznik
+    const char* name;
+    const char* category;
+    int thread;
+    int64_t start;
+    int64_t duration;
+    double value;
+    std::string detail;
+};
+
+// tor zdarzen GPU - poza numeracja watkow CPU
+const int GPU_THREAD = 1000;
+
+const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+
+std::mutex traceMutex;
+std::vector<TraceEvent> traceEvents;
+std::map<int, std::string> threadNames;
+std::atomic<int> nextThread{ 0 };
+thread_local int traceThread = -1;
+
+int currentThread()
+{
+    if (traceThread < 0) traceThread = nextThread.fetch_add(1);
+    return traceThread;
+}
+
+void push(TraceEvent&& event)
+{
+    std::lock_guard<std::mutex> lock(traceMutex);
+    traceEvents.push_back(std::move(event));
+}
+
+void writeString(FILE* file, const char* text)
+{
+    fputs(jsonString(text).c_str(), file);
+}
+
+}
+
+void traceStart()
+{
+    {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        traceEvents.clear();
+        traceEvents.reserve(1 << 16);
+    }
+    traceActive.store(true, std::memory_order_release);
+}
+
+void traceStop()
+{
+    traceActive.store(false, std::memory_order_release);
+}
+
+int64_t traceTimestamp(std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - traceEpoch).count();
+}
+
+int64_t traceNow()
+{
+    return traceTimestamp(std::chrono::steady_clock::now());
+}
+
+void traceThreadName(const std::string& name)
+{
+    int thread = currentThread();
+    std::lock_guard<std::mutex> lock(traceMutex);
+    threadNames[thread] = name;
+}
+
+void traceSpan(const char* name, const char* category, int64_t start, int64_t duration, const char* detail)
+{
+    if (!traceEnabled()) return;
+    push({ 'X', name, category, currentThread(), start, duration, 0.0, detail ? detail : "" });
+}
+
+void traceGpuSpan(const char* name, int64_t start, int64_t duration)
+{
+    if (!traceEnabled()) return;
+    push({ 'X', name, "gpu", GPU_THREAD, start, duration, 0.0, "" });
+}
+
+void traceCounter(const char* name, double value)
+{
+    if (!traceEnabled()) return;
+    push({ 'C', name, "counter", currentThread(), traceNow(), 0, value, "" });
+}
+
+std::string jsonString(const std::string& text)
+{
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        }
+        else out += c;
+    }
+    return out + "\"";
+}
+
+bool traceWrite(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        std::cerr << "ERROR: nie mozna zapisac sladu " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"OceanGL\"}}");
+    fprintf(file, ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"GPU\"}}", GPU_THREAD);
+    for (const auto& thread : threadNames) {
+        fprintf(file, ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", thread.first);
+        writeString(file, thread.second.c_str());
+        fprintf(file, "}}");
+    }
+    for (const TraceEvent& event : traceEvents) {
+        fprintf(file, ",\n{\"ph\":\"%c\",\"name\":", event.phase);
+        writeString(file, event.name);
+        fprintf(file, ",\"cat\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%lld", event.category, event.thread, (long long)event.start);
+        if (event.phase == 'X') {
+            fprintf(file, ",\"dur\":%lld", (long long)event.duration);
+            if (!event.detail.empty()) {
+                fprintf(file, ",\"args\":{\"detail\":");
+                writeString(file, event.detail.c_str());
+                fprintf(file, "}");
+            }
+        }
+        else {
+            fprintf(file, ",\"args\":{\"value\":%g}", event.value);
+        }
+        fprintf(file, "}");
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    std::cout << "INFO: Slad " << traceEvents.size() << " zdarzen zapisany do " << path << std::endl;
+    return ok;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#ifndef TRACE_CLASS_H
+#define TRACE_CLASS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Zapis osi czasu w formacie Chrome Trace Event (JSON) do obejrzenia
+// w Perfetto / chrome://tracing. Zawsze wkompilowane; gdy zapis jest
+// wylaczony, kazdy punkt pomiarowy kosztuje jedno atomowe odczytanie flagi.
+// Zdarzenia ze wszystkich watkow trafiaja do jednego bufora pod mutexem.
+
+extern std::atomic<bool> traceActive;
+
+inline bool traceEnabled() { return traceActive.load(std::memory_order_relaxed); }
+
+// czysci bufor i wlacza zapis / wylacza zapis (bufor zostaje)
+void traceStart();
+void traceStop();
+// bufor jako {"traceEvents": [...]}
+bool traceWrite(const std::string& path);
+
+// mikrosekundy od startu programu (zegar steady)
+int64_t traceNow();
+int64_t traceTimestamp(std::chrono::steady_clock::time_point time);
+
+// nazwa biezacego watku na osi czasu (mozna wolac przy wylaczonym zapisie)
+void traceThreadName(const std::string& name);
+
+// name i category musza zyc do traceWrite (literaly); detail jest kopiowany
+void traceSpan(const char* name, const char* category, int64_t start, int64_t duration, const char* detail = nullptr);
+// czas GPU na osobnym torze "GPU"
+void traceGpuSpan(const char* name, int64_t start, int64_t duration);
+void traceCounter(const char* name, double value);
+
+// napis JSON w cudzyslowie, znaki sterujace jako \u00XX (slad i raporty benchmarku)
+std::string jsonString(const std::string& text);
+
+// Przedzial na biezacym watku na czas zycia obiektu
+class TraceScope
+{
+public:
+    TraceScope(const char* name, const char* category, const char* detail = nullptr)
+        : name(name), category(category), detail(detail), start(traceEnabled() ? traceNow() : -1) {}
+    ~TraceScope()
+    {
+        if (start >= 0) traceSpan(name, category, start, traceNow() - start, detail);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    const char* detail;
+    int64_t start;
+};
+
+#endif
@@ -4,12 +4,21 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 
-uniform vec3 cameraPos;
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightPos;
+    vec3 lightColor;
+};
+
 uniform samplerCube skybox;
 
 void main()
 {
-    vec3 I = normalize(FragPos - cameraPos);
+    vec3 I = normalize(FragPos - viewPos);
     vec3 R = reflect(I, normalize(Normal));
     vec3 envColor = texture(skybox, R).rgb;
 
@@ -5,9 +5,17 @@ layout(location = 1) in vec3 aNormal;
 out vec3 FragPos;
 out vec3 Normal;
 
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightPos;
+    vec3 lightColor;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
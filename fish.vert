@@ -2,22 +2,40 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in vec4 aInstance; // xyz = pozycja, w = yaw (divisor 1)
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
 
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightPos;
+    vec3 lightColor;
+};
 
 uniform vec2 uvScale;
 uniform vec2 uvOffset;
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform float yawOffset;
+uniform float fishScale;
+
+// obrot wokol osi Y, jak glm::rotate(..., vec3(0, 1, 0))
+vec3 rotateY(vec3 v, float angle)
+{
+    float c = cos(angle);
+    float s = sin(angle);
+    return vec3(c * v.x + s * v.z, v.y, -s * v.x + c * v.z);
+}
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    float yaw = aInstance.w + yawOffset;
+    FragPos = aInstance.xyz + rotateY(aPos * fishScale, yaw);
+    Normal = rotateY(aNormal, yaw);
     TexCoords = aTexCoords * uvScale + uvOffset;
     gl_Position = projection * view * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+}
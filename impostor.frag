@@ -0,0 +1,41 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec2 AtlasCoords;
+flat in mat3 NormalMatrix;
+
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightPos;
+    vec3 lightColor;
+};
+
+uniform sampler2D impostorAlbedo;
+uniform sampler2D impostorNormal;
+uniform float ambientStrength;  // jak w shaderze pelnej siatki (plant 0.4, fish 0.3)
+
+void main()
+{
+    vec4 albedo = texture(impostorAlbedo, AtlasCoords);
+    if (albedo.a < 0.5) discard;
+
+    // oswietlenie jak plant.frag / fish.frag, normalna z atlasu
+    vec3 norm = normalize(NormalMatrix * (texture(impostorNormal, AtlasCoords).rgb * 2.0 - 1.0));
+    vec3 ambient = ambientStrength * lightColor;
+    vec3 lightDir = normalize(lightPos - FragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor;
+
+    float specularStrength = 0.3;
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 16);
+    vec3 specular = specularStrength * spec * lightColor;
+
+    FragColor = vec4((ambient + diffuse) * albedo.rgb + specular, 1.0);
+}
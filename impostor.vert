@@ -0,0 +1,70 @@
+#version 330 core
+layout (location = 0) in vec2 aCorner;          // -1..1
+layout (location = 3) in mat4 aInstanceModel;   // lokacje 3..6, divisor 1
+
+out vec3 FragPos;
+out vec2 AtlasCoords;
+flat out mat3 NormalMatrix;
+
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightPos;
+    vec3 lightColor;
+};
+
+uniform vec3 boundsCenter;      // sfera otaczajaca siatki (uklad modelu)
+uniform float boundsRadius;
+uniform int impostorFrames;
+
+float signNotZero(float v)
+{
+    return v >= 0.0 ? 1.0 : -1.0;
+}
+
+// te same wzory co octahedralEncode/Decode w Impostor.cpp
+vec2 octahedralEncode(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 p = n.xz;
+    if (n.y < 0.0)
+        p = vec2((1.0 - abs(p.y)) * signNotZero(p.x), (1.0 - abs(p.x)) * signNotZero(p.y));
+    return p * 0.5 + 0.5;
+}
+
+vec3 octahedralDecode(vec2 uv)
+{
+    vec2 p = uv * 2.0 - 1.0;
+    vec3 n = vec3(p.x, 1.0 - abs(p.x) - abs(p.y), p.y);
+    if (n.y < 0.0)
+        n.xz = vec2((1.0 - abs(n.z)) * signNotZero(n.x), (1.0 - abs(n.x)) * signNotZero(n.z));
+    return normalize(n);
+}
+
+void main()
+{
+    mat3 model = mat3(aInstanceModel);
+    vec3 center = (aInstanceModel * vec4(boundsCenter, 1.0)).xyz;
+
+    // kierunek do kamery w ukladzie modelu (skala jednorodna - wystarczy transpozycja)
+    vec3 toCamera = normalize(transpose(model) * (viewPos - center));
+    float frames = float(impostorFrames);
+    vec2 frame = clamp(floor(octahedralEncode(toCamera) * frames), 0.0, frames - 1.0);
+
+    // plaszczyzna najblizszego ujecia - ta sama baza co glm::lookAt przy wypalaniu
+    vec3 d = octahedralDecode((frame + 0.5) / frames);
+    vec3 up = abs(d.y) > 0.99 ? vec3(0.0, 0.0, 1.0) : vec3(0.0, 1.0, 0.0);
+    vec3 forward = -d;
+    vec3 right = normalize(cross(forward, up));
+    vec3 trueUp = cross(right, forward);
+
+    vec3 local = boundsCenter + (aCorner.x * right + aCorner.y * trueUp) * boundsRadius;
+    vec4 worldPos = aInstanceModel * vec4(local, 1.0);
+    FragPos = worldPos.xyz;
+    AtlasCoords = (frame + aCorner * 0.5 + 0.5) / frames;
+    NormalMatrix = model;
+    gl_Position = projection * view * worldPos;
+}
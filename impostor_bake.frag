@@ -0,0 +1,23 @@
+#version 330 core
+layout (location = 0) out vec4 Albedo;
+layout (location = 1) out vec4 NormalOut;
+
+in vec3 Normal;
+in vec2 TexCoords;
+
+uniform vec3 baseColor;
+uniform bool useTexture;
+uniform sampler2D texture_diffuse1;
+
+void main()
+{
+    vec3 color = baseColor;
+    if (useTexture) {
+        // jak w fish.frag
+        color = texture(texture_diffuse1, TexCoords).rgb;
+        if (length(color) < 0.1)
+            color = vec3(1.0, 0.5, 0.3);
+    }
+    Albedo = vec4(color, 1.0);
+    NormalOut = vec4(normalize(Normal) * 0.5 + 0.5, 1.0);
+}
@@ -0,0 +1,19 @@
+#version 330 core
+// Wypalanie atlasu impostora: siatka w ukladzie modelu, rzut ortogonalny ujecia
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+out vec3 Normal;
+out vec2 TexCoords;
+
+uniform mat4 viewProjection;
+uniform vec2 uvScale;
+uniform vec2 uvOffset;
+
+void main()
+{
+    Normal = aNormal;
+    TexCoords = aTexCoords * uvScale + uvOffset;
+    gl_Position = viewProjection * vec4(aPos, 1.0);
+}
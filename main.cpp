@@ -12,20 +12,38 @@
 #include <tuple>
 #include <cstdlib>   
 #include <ctime>     
-
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "tiny_obj_loader.h"
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
 
 #include "shaderClass.h"
 #include "Camera.h"
+#include "StreamBuffer.h"
+#include "FrameData.h"
+#include "Mesh.h"
+#include "MeshCache.h"
+#include "Texture.h"
+#include "JobSystem.h"
+#include "AssetLoader.h"
+#include "OceanFFT.h"
+#include "GerstnerWaves.h"
+#include "OceanClipmap.h"
+#include "FishSystem.h"
+#include "Benchmarks.h"
+#include "Simulation.h"
+#include "Random.h"
+#include "Frustum.h"
+#include "SphereBVH.h"
+#include "GpuCulling.h"
+#include "Impostor.h"
+#include "HeadlessContext.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "FrameBenchmark.h"
+#include "SceneConfig.h"
 
-unsigned int createOceanMesh(int width, int depth, std::vector<float>& vertices, std::vector<unsigned int>& indices);
 unsigned int createGroundMesh(int width, int depth, std::vector<float>& vertices, std::vector<unsigned int>& indices);
-unsigned int loadTexture(const char* path);
-unsigned int loadCubemap(std::vector<std::string> faces);
-bool loadObj(const char* path, std::vector<float>& out_vertices, int& vertex_count, unsigned int& vao, unsigned int& vbo);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback_wrapper(GLFWwindow* window, double, double);
 const float WATER_SURFACE_Y = 0.0f;
@@ -44,17 +62,9 @@ glm::vec3 lightPos = glm::vec3(500.0f, 1000.0f, 300.0f);
 glm::vec3 lightColor = glm::vec3(1.0f, 1.0f, 0.95f);
 Camera camera(SCR_WIDTH, SCR_HEIGHT, glm::vec3(0.0f, 8.0f, 15.0f));
 
-//babelki
-struct BubbleInstance {
-    glm::vec3 position;
-    float     speed;
-    float     scale;
-};
-
+//babelki (BubbleInstance w Simulation.h)
 std::vector<BubbleInstance> bubbles;
-std::vector<float> bubbleVerts;
-unsigned int bubbleVAO, bubbleVBO;
-int bubbleCount = 0;
+Mesh bubbleMesh;
 
 
 //roslinki
@@ -65,32 +75,37 @@ struct PlantInstance {
 };
 
 struct PlantType {
-    unsigned int vao;
-    int vertexCount;
+    Mesh mesh;
     float scaleMin, scaleMax;
     glm::vec3 color;
+    float tilt;                     //obrot wokol X (modele coral/star sa "na lezaco")
+    std::vector<glm::mat4> models{};  //macierze model instancji (statyczne, w kolejnosci slotow BVH)
+    SphereBVH bvh{};                //sfery otaczajace w swiecie
+    int instanceCount = 0;
+    ImpostorAtlas impostor{};       //dalekie instancje
 };
-
-//struktury ryb
-struct FishInstance {
-    glm::vec3 position;
-    glm::vec3 velocity;
-    float     yaw;
-};
-
+void buildPlantInstances(PlantType& type, const std::vector<PlantInstance>& instances);
+void bindPlantInstances(const PlantType& type, unsigned int buffer, GLintptr offset);
+//kubelki instancji: poziomy LOD siatki, ostatni to impostory
+const int LOD_BUCKETS = MESH_MAX_LODS + 1;
+const int IMPOSTOR_BUCKET = MESH_MAX_LODS;
+int instanceLod(const Mesh& mesh, const glm::vec3& center, float radius, const glm::vec3& eye, float lodScale, bool impostor);
+void countLods(const int* lods, int count, int lodStart[LOD_BUCKETS + 1]);
+
+//struktury ryb (pozycje i predkosci w FishSystem)
 struct FishType {
-    unsigned int vao;
-    int          vertexCount;
+    Mesh         mesh;
     unsigned int texture;
     float        speed;   //predkosc
     float        scale;   //rozmiar
     float        yawOffset;
+    glm::vec2    uvScale = glm::vec2(1.0f);
+    glm::vec2    uvOffset = glm::vec2(0.0f);
+    ImpostorAtlas impostor{};
 };
+glm::mat4 fishModelMatrix(const glm::vec4& positionYaw, const FishType& type);
 
-//parametry lawic
-constexpr int   GROUPS_PER_TYPE = 60;   //liczba lawic na gatunek
-constexpr int   GROUP_MIN = 8;
-constexpr int   GROUP_MAX = 14;
+//parametry lawic (liczba i rozmiar lawic w SceneConfig)
 constexpr float SPAWN_RADIUS_XZ = 15.0f;  //obszar X‑Z przed kamerą
 constexpr float SPAWN_Z_OFFSET = 5.0f;   //startowe (kamera.z − offset)
 constexpr float DESPAWN_Z = -120.0f; //po przekroczeniu – respawn
@@ -115,30 +130,141 @@ unsigned int quadVAO, quadVBO;
 
 
 //main
-int main()
+int main(int argc, char** argv)
 {
+    //--validate-ocean: porownanie FFT z referencja CPU i wyjscie
+    //--bench-boids [n]: benchmark lawic na CPU, bez okna
+    //--bench-jobs: narzut planisty zadan
+    //--bench-rng: Random vs rand()
+    //--bench-cull [n]: culling n roslin liniowo vs przez BVH
+    //--bench-lod [plik.obj]: generowanie LOD-ow i sprawdzenie szwow uv (domyslnie clownfish.obj)
+    //--seed n: ziarno wszystkich losowan (domyslnie z zegara)
+    //--headless [n]: n klatek (domyslnie 60) bez okna, przez EGL
+    //--frames-out dir: w trybie bez okna zapis kazdej klatki do dir/frame_NNNN.ppm
+    //--trace plik.json: slad Chrome Trace od startu (z ladowaniem zasobow)
+    //--trace-frames n: liczba klatek w sladzie (domyslnie 300)
+    //--benchmark: przelot po sciezce kamery, stale ziarno (1, o ile nie ma --seed) i krok 1/60 s,
+    //  --warmup n (120) klatek rozgrzewki, --frames n (600) mierzonych, raport JSON w --benchmark-out (benchmark.json)
+    //--camera-path plik: sciezka kamery benchmarku zamiast wbudowanej
+    //--record-path plik: zapis sciezki kamery z recznego lotu (do --camera-path)
+    //--fish-groups n, --plants-per-type n, --bubbles n, --ocean-grid n, --ground n: rozmiary sceny (SceneConfig)
+    //--sweep fish|plants|ocean|all: benchmark bez okna dla kolejnych rozmiarow, CSV w --sweep-out (sweep.csv)
+    bool validateOcean = false;
+    SceneConfig scene;
+    std::string sweep;
+    std::string sweepOut = "sweep.csv";
+    std::string sweepRowFile, sweepRowSubsystem;
+    int sweepRowSize = 0;
+    bool headless = false;
+    int headlessFrames = 60;
+    std::string framesOut;
+    std::string tracePath;
+    int traceFrames = 300;
+    bool benchmark = false;
+    int benchmarkWarmup = 120;
+    int benchmarkFrames = 600;
+    std::string benchmarkOut = "benchmark.json";
+    std::string cameraPathFile;
+    std::string recordPathFile;
+    bool seedGiven = false;
+    uint64_t seed = static_cast<uint64_t>(time(nullptr));
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--validate-ocean") validateOcean = true;
+        else if (arg == "--bench-boids") {
+            int fishCount = (i + 1 < argc) ? atoi(argv[i + 1]) : 0;
+            return runBoidsBenchmark(fishCount > 0 ? fishCount : 100000);
+        }
+        else if (arg == "--bench-jobs") return runJobsBenchmark();
+        else if (arg == "--bench-rng") return runRandomBenchmark();
+        else if (arg == "--bench-cull") {
+            int plantCount = (i + 1 < argc) ? atoi(argv[i + 1]) : 0;
+            return runCullBenchmark(plantCount > 0 ? plantCount : 200000);
+        }
+        else if (arg == "--bench-lod") return runLodBenchmark((i + 1 < argc) ? argv[i + 1] : "clownfish.obj");
+        else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+            seedGiven = true;
+        }
+        else if (arg == "--headless") {
+            headless = true;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0) headlessFrames = atoi(argv[++i]);
+        }
+        else if (arg == "--frames-out" && i + 1 < argc) framesOut = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc) tracePath = argv[++i];
+        else if (arg == "--trace-frames" && i + 1 < argc) traceFrames = std::max(1, atoi(argv[++i]));
+        else if (arg == "--benchmark") benchmark = true;
+        else if (arg == "--warmup" && i + 1 < argc) benchmarkWarmup = std::max(0, atoi(argv[++i]));
+        else if (arg == "--frames" && i + 1 < argc) benchmarkFrames = std::max(1, atoi(argv[++i]));
+        else if (arg == "--benchmark-out" && i + 1 < argc) benchmarkOut = argv[++i];
+        else if (arg == "--camera-path" && i + 1 < argc) cameraPathFile = argv[++i];
+        else if (arg == "--record-path" && i + 1 < argc) recordPathFile = argv[++i];
+        else if (arg == "--fish-groups" && i + 1 < argc) scene.fishGroupsPerType = std::max(0, atoi(argv[++i]));
+        else if (arg == "--plants-per-type" && i + 1 < argc) scene.plantsPerType = std::max(0, atoi(argv[++i]));
+        else if (arg == "--bubbles" && i + 1 < argc) scene.bubbles = std::max(0, atoi(argv[++i]));
+        //gridHalf musi byc parzyste
+        else if (arg == "--ocean-grid" && i + 1 < argc) scene.oceanGridHalf = std::max(2, (atoi(argv[++i]) / 2) & ~1);
+        else if (arg == "--ground" && i + 1 < argc) scene.groundResolution = std::max(2, atoi(argv[++i]));
+        else if (arg == "--sweep" && i + 1 < argc) sweep = argv[++i];
+        else if (arg == "--sweep-out" && i + 1 < argc) sweepOut = argv[++i];
+        //wewnetrzne: proces potomny --sweep dopisuje wiersz CSV
+        else if (arg == "--sweep-row" && i + 3 < argc) {
+            sweepRowFile = argv[++i];
+            sweepRowSubsystem = argv[++i];
+            sweepRowSize = atoi(argv[++i]);
+        }
+    }
+    if (!sweep.empty()) return runSceneSweep(argv[0], sweep, sweepOut, benchmarkWarmup, benchmarkFrames);
+    CameraPath cameraPath = CameraPath::flythrough();
+    if (!cameraPathFile.empty() && !cameraPath.load(cameraPathFile)) return 1;
+    if (benchmark && !seedGiven) seed = 1;
+    traceThreadName("main");
+    if (!tracePath.empty()) traceStart();
+    //klawisz T zapisuje slad kolejnych traceFrames klatek
+    if (tracePath.empty()) tracePath = "oceangl_trace.json";
+    int traceFramesLeft = traceEnabled() ? traceFrames : 0;
+
     //init
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OceanGL", NULL, NULL);
-    if (window == NULL) {
-        std::cerr << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
+    GLFWwindow* window = NULL;
+    HeadlessContext headlessContext;
+    GLADloadproc glLoader = NULL;
+    if (headless) {
+        //bez okna - bez glfwInit, ktore na X11 wymaga wyswietlacza
+        if (!headlessContext.create()) return -1;
+        glLoader = headlessContext.loader();
+    }
+    else {
+        glfwInit();
+        //najpierw GL 4.3 (culling na GPU), bez niego 3.3 i culling na CPU
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OceanGL", NULL, NULL);
+        if (window == NULL) {
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+            window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OceanGL", NULL, NULL);
+        }
+        if (window == NULL) {
+            std::cerr << "Failed to create GLFW window" << std::endl;
+            glfwTerminate();
+            return -1;
+        }
+        glfwMakeContextCurrent(window);
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetCursorPosCallback(window, mouse_callback_wrapper);
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+        glLoader = (GLADloadproc)glfwGetProcAddress;
     }
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    glfwSetCursorPosCallback(window, mouse_callback_wrapper);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    if (!gladLoadGLLoader(glLoader)) {
         std::cerr << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
     std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
+    bool gpuCullingSupported = loadGpuCulling(glLoader);
+    //kontekst EGL nie ma domyslnego bufora - viewport ustawiamy sami
+    glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
 
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
@@ -152,15 +278,50 @@ int main()
     Shader groundShader("ground.vert", "ground.frag");
     Shader bubbleShader("buble.vert", "buble.frag");
     Shader postProcessShader("postprocess.vert", "postprocess.frag");
-
-
-    //ocean & dno
-    std::vector<float> oceanVertices;   std::vector<unsigned int> oceanIndices;
-    unsigned int oceanVAO = createOceanMesh(150, 150, oceanVertices, oceanIndices);
-    int oceanIndexCount = static_cast<int>(oceanIndices.size());
+    Shader* cullShader = gpuCullingSupported ? new Shader("scenery_cull.comp") : nullptr;
+    Shader impostorShader("impostor.vert", "impostor.frag");
+
+    //wspolny UBO z kamera i swiatlem
+    FrameUniformBuffer frameUniforms;
+    for (const Shader* shader : { &oceanShader, &fishShader, &plantShader, &skyboxShader, &groundShader, &bubbleShader, &impostorShader })
+        shader->bindUniformBlock("FrameData", FRAME_DATA_BINDING);
+
+
+    //ocean FFT (klawisz F przelacza Gerstner <-> FFT)
+    OceanFFT oceanFFT;
+    oceanFFT.initGPU();
+    if (validateOcean) {
+        float cpuError = OceanFFT::selfTest(oceanFFT.params().resolution);
+        float gpuError = oceanFFT.validateGPU(1.5f);
+        std::cout << "INFO: Ocean FFT - blad CPU vs DFT: " << cpuError << ", blad GPU vs CPU: " << gpuError << std::endl;
+        bool passed = cpuError < 1e-3f && gpuError < 1e-2f;
+        std::cout << (passed ? "INFO: Walidacja oceanu OK" : "ERROR: Walidacja oceanu nieudana") << std::endl;
+        oceanFFT.Delete();
+        headlessContext.Delete();
+        glfwTerminate();
+        return passed ? 0 : 1;
+    }
+    bool oceanFFTMode = false;
+    bool fftKeyWasDown = false;
+    oceanShader.Activate();
+    oceanShader.setInt("fftDisplacement", 1);
+    oceanShader.setInt("fftNormal", 2);
+    oceanShader.setFloat("fftPatchSize", oceanFFT.params().patchSize);
+    oceanShader.setInt("fftResolution", oceanFFT.params().resolution);
+
+    //fale Gerstnera - parametry w uniformach, wysylane raz
+    GerstnerWaves oceanWaves;
+    oceanWaves.bind(oceanShader);
+    oceanWaves.upload(oceanShader);
+
+    //ocean (clipmapa wokol kamery) & dno
+    OceanClipmapParams clipmapParams;
+    clipmapParams.gridHalf = scene.oceanGridHalf;
+    OceanClipmap oceanClipmap(clipmapParams);
+    oceanClipmap.bind(oceanShader);
 
     std::vector<float> groundVertices;  std::vector<unsigned int> groundIndices;
-    unsigned int groundVAO = createGroundMesh(150, 150, groundVertices, groundIndices);
+    unsigned int groundVAO = createGroundMesh(scene.groundResolution, scene.groundResolution, groundVertices, groundIndices);
     int groundIndexCount = static_cast<int>(groundIndices.size());
 
     //skybox
@@ -180,98 +341,159 @@ int main()
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glBindVertexArray(0);
 
+    //zasoby ladowane rownolegle: dekodowanie/parsowanie na puli watkow, GL na watku glownym
+    auto assetLoadStart = std::chrono::steady_clock::now();
+    JobSystem jobs;
+    AssetLoader assets(jobs);
+
     std::vector<std::string> faces = { "px.png", "nx.png", "py.png", "ny.png", "pz.png", "nz.png" };
-    unsigned int cubemapTexture = loadCubemap(faces);
+    unsigned int cubemapTexture = 0;
+    assets.loadCubemap(faces, cubemapTexture);
 
     //tex ryb i piasku
-    unsigned int fishTexture = loadTexture("fish_texture.png");
-    unsigned int fishTexture1 = loadTexture("blazenek.png");
-    unsigned int fishTexture2 = loadTexture("ladnakolorowa.png");
-    unsigned int groundTexture = loadTexture("tex-4k.jpg");
+    unsigned int fishTexture = 0, fishTexture1 = 0, fishTexture2 = 0, groundTexture = 0;
+    assets.loadTexture("fish_texture.png", fishTexture);
+    assets.loadTexture("blazenek.png", fishTexture1);
+    assets.loadTexture("ladnakolorowa.png", fishTexture2);
+    assets.loadTexture("tex-4k.jpg", groundTexture);
 
     //modele rybek
-    std::vector<float> fishVertices;
-    unsigned int fishVAO = 0, fishVBO = 0; int fishVertexCount = 0;
-    loadObj("C:/Users/kiqar/Desktop/fish.obj", fishVertices, fishVertexCount, fishVAO, fishVBO);
-
-    std::vector<float> fish2Vertices, fish3Vertices;
-    unsigned int fish2VAO = 0, fish2VBO = 0; int fish2VertexCount = 0;
-    unsigned int fish3VAO = 0, fish3VBO = 0; int fish3VertexCount = 0;
-    loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/wrednerybsko.obj", fish2Vertices, fish2VertexCount, fish2VAO, fish2VBO);
-    loadObj("C:/Users/kiqar/Desktop/ladnekolorowe.obj", fish3Vertices, fish3VertexCount, fish3VAO, fish3VBO);
+    Mesh fishMesh, fish2Mesh, fish3Mesh;
+    assets.loadObj("C:/Users/kiqar/Desktop/fish.obj", fishMesh);
+    assets.loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/wrednerybsko.obj", fish2Mesh);
+    assets.loadObj("C:/Users/kiqar/Desktop/ladnekolorowe.obj", fish3Mesh);
 
     //modele roslinek
-    std::vector<float> coralVertices, pinkVertices, redVertices, starVertices;
-    unsigned int coralVAO, pinkVAO, redVAO, starVAO;
-    unsigned int coralVBO, pinkVBO, redVBO, starVBO;
-    int coralCount = 0, pinkCount = 0, redCount = 0, starCount = 0;
-
-    loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/coral2.obj", coralVertices, coralCount, coralVAO, coralVBO);
-    loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/pinkcoral.obj", pinkVertices, pinkCount, pinkVAO, pinkVBO);
-    loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/redcoral.obj", redVertices, redCount, redVAO, redVBO);
-    loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/starfish.obj", starVertices, starCount, starVAO, starVBO);
+    Mesh coralMesh, pinkMesh, redMesh, starMesh;
+    assets.loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/coral2.obj", coralMesh);
+    assets.loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/pinkcoral.obj", pinkMesh);
+    assets.loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/redcoral.obj", redMesh);
+    assets.loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/starfish.obj", starMesh);
 
     //babelki i generowanie ich
-    loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/bubbles.obj", bubbleVerts, bubbleCount, bubbleVAO, bubbleVBO);
-    for (int i = 0; i < 10; ++i) {
-        float x = (rand() / (float)RAND_MAX - 0.5f) * 300.0f;
-        float z = (rand() / (float)RAND_MAX - 0.5f) * 300.0f;
-        float y = -10.0f - ((rand() / (float)RAND_MAX) * 4.0f);
-        float speed = 0.01f + ((rand() / (float)RAND_MAX) * 0.1f);
-        float scale = 0.0001f + ((rand() / (float)RAND_MAX) * 0.001f);
+    assets.loadObj("C:/Users/kiqar/source/repos/terazzadziala/terazzadziala/bubbles.obj", bubbleMesh);
+    assets.finish();
+
+    //cache pusty = zimny start, same trafienia = cieply start
+    double assetLoadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - assetLoadStart).count();
+    const MeshCacheStats& cacheStats = meshCacheStats();
+    std::cout << "INFO: Zasoby zaladowane w " << assetLoadMs << " ms (" << jobs.workerCount() + 1 << " watkow, "
+        << (cacheStats.misses == 0 ? "cieply start" : "zimny start") << ", cache: "
+        << cacheStats.hits << " trafien, " << cacheStats.misses << " pudel)" << std::endl;
+
+    //strumienie: 0 - spawn sceny, 1 - respawn ryb, 2 - respawn babelkow
+    std::cout << "INFO: Ziarno: " << seed << " (--seed " << seed << " powtarza scene)" << std::endl;
+    Random rootRandom(seed);
+    Random spawnRandom = rootRandom.stream(0);
+
+    for (int i = 0; i < scene.bubbles; ++i) {
+        float x = (spawnRandom.nextFloat() - 0.5f) * 300.0f;
+        float z = (spawnRandom.nextFloat() - 0.5f) * 300.0f;
+        float y = -10.0f - (spawnRandom.nextFloat() * 4.0f);
+        float speed = 0.01f + (spawnRandom.nextFloat() * 0.1f);
+        float scale = 0.0001f + (spawnRandom.nextFloat() * 0.001f);
         bubbles.push_back({ glm::vec3(x, y, z), speed, scale });
     }
 
     std::vector<PlantType> plantTypes = {
-    { coralVAO, coralCount, 0.03f, 0.05f, glm::vec3(0.0f, 0.128f, 0.0f) },
-    { pinkVAO,  pinkCount,  0.1f, 0.4f, glm::vec3(1.0f, 0.5f, 0.8f) },
-    { redVAO,   redCount,   0.03f, 0.06f, glm::vec3(0.9f, 0.1f, 0.1f) },
-    { starVAO,  starCount,  0.2f, 0.4f, glm::vec3(0.3f, 0.6f, 1.0f) }
+    { coralMesh, 0.03f, 0.05f, glm::vec3(0.0f, 0.128f, 0.0f), glm::radians(270.0f) },
+    { pinkMesh,  0.1f, 0.4f, glm::vec3(1.0f, 0.5f, 0.8f), glm::radians(360.0f) },
+    { redMesh,   0.03f, 0.06f, glm::vec3(0.9f, 0.1f, 0.1f), glm::radians(270.0f) },
+    { starMesh,  0.2f, 0.4f, glm::vec3(0.3f, 0.6f, 1.0f), glm::radians(270.0f) }
     };
 
     std::vector<std::vector<PlantInstance>> plantInstances(plantTypes.size());
-    srand(static_cast<unsigned int>(time(nullptr)));
 
     for (size_t t = 0; t < plantTypes.size(); ++t) {
-        for (int i = 0; i < 400; ++i) {
-            float x = (rand() / (float)RAND_MAX - 0.5f) * 300.0f;
-            float z = (rand() / (float)RAND_MAX - 0.5f) * 300.0f;
+        for (int i = 0; i < scene.plantsPerType; ++i) {
+            float x = (spawnRandom.nextFloat() - 0.5f) * 300.0f;
+            float z = (spawnRandom.nextFloat() - 0.5f) * 300.0f;
             float y = -10.0f;
-            float scale = plantTypes[t].scaleMin + (rand() / (float)RAND_MAX) * (plantTypes[t].scaleMax - plantTypes[t].scaleMin);
-            float yaw = (rand() / (float)RAND_MAX) * 6.28318f;
+            float scale = spawnRandom.range(plantTypes[t].scaleMin, plantTypes[t].scaleMax);
+            float yaw = spawnRandom.nextFloat() * 6.28318f;
             plantInstances[t].push_back({ glm::vec3(x, y, z), scale, yaw });
         }
+        buildPlantInstances(plantTypes[t], plantInstances[t]);
+    }
+
+    //culling na GPU: wszystkie rosliny w jednym SSBO, typ = zakres = jedna komenda
+    GpuInstanceSet* plantGpu = nullptr;
+    std::vector<GpuDrawGroup> plantGroups;
+    if (gpuCullingSupported) {
+        std::vector<glm::mat4> allModels;
+        std::vector<glm::vec4> allSpheres;
+        for (const PlantType& type : plantTypes) {
+            plantGroups.push_back({ &type.mesh, static_cast<int>(allModels.size()), type.instanceCount, 0.0f, &type.impostor });
+            allModels.insert(allModels.end(), type.models.begin(), type.models.end());
+            for (int s = 0; s < type.instanceCount; ++s)
+                allSpheres.push_back(glm::vec4(type.bvh.sortedX[s], type.bvh.sortedY[s], type.bvh.sortedZ[s], type.bvh.sortedR[s]));
+        }
+        plantGpu = new GpuInstanceSet(*cullShader, 4, static_cast<int>(allModels.size()), static_cast<int>(plantGroups.size()));
+        if (!allModels.empty())
+            plantGpu->upload(&allModels[0][0], allSpheres.data(), static_cast<int>(allModels.size()), false);
     }
 
     std::vector<FishType> fishTypes = {
-        { fishVAO,  fishVertexCount, fishTexture,  0.33f, 0.30f,  glm::radians(180.0f) },
-        { fish2VAO, fish2VertexCount, fishTexture1, 0.76f, 0.85f,  glm::radians(90.0f) },
-        { fish3VAO, fish3VertexCount, fishTexture2, 0.20f, 0.20f,  glm::radians(-90.0f) }
+        { fishMesh,  fishTexture,  0.33f, 0.30f,  glm::radians(180.0f) },
+        { fish2Mesh, fishTexture1, 0.76f, 0.85f,  glm::radians(90.0f), glm::vec2(1.0f, 0.5f), glm::vec2(0.0f, 0.5f) },
+        { fish3Mesh, fishTexture2, 0.20f, 0.20f,  glm::radians(-90.0f) }
     };
 
-    srand(static_cast<unsigned int>(time(nullptr)));
-    std::map<int, std::vector<FishInstance>> fishInstances;
+    //impostory: kazda siatka roslin i ryb wypalana raz do atlasu oktaedrycznego
+    {
+        Shader bakeShader("impostor_bake.vert", "impostor_bake.frag");
+        for (PlantType& type : plantTypes)
+            type.impostor.bake(bakeShader, type.mesh, 0, type.color);
+        for (FishType& type : fishTypes)
+            type.impostor.bake(bakeShader, type.mesh, type.texture, glm::vec3(1.0f), type.uvScale, type.uvOffset);
+        bakeShader.Delete();
+    }
+
+    FishBounds fishBounds;
+    fishBounds.maxHeight = MAX_FISH_HEIGHT;
+    fishBounds.despawnZ = DESPAWN_Z;
+    fishBounds.spawnRadiusXZ = SPAWN_RADIUS_XZ;
+    fishBounds.spawnZOffset = SPAWN_Z_OFFSET;
+    FishSystem fishSystem(fishBounds, BoidParams(), rootRandom.stream(1));
 
+    //gatunek w FishSystem ma ten sam indeks co w fishTypes
     for (size_t t = 0; t < fishTypes.size(); ++t) {
-        std::vector<FishInstance> list;
-        for (int g = 0; g < GROUPS_PER_TYPE; ++g) {
-            int groupSize = GROUP_MIN + rand() % (GROUP_MAX - GROUP_MIN + 1);
-            float spawnX = camera.Position.x + (rand() / (float)RAND_MAX - 0.5f) * 100.0f;
-            float spawnZ = camera.Position.z + (rand() / (float)RAND_MAX - 0.5f) * 100.0f;
-            float spawnY = -9.0f + ((rand() / (float)RAND_MAX) * 6.0f);
+        fishSystem.addSpecies(fishTypes[t].speed);
+        for (int g = 0; g < scene.fishGroupsPerType; ++g) {
+            int groupSize = spawnRandom.rangeInt(scene.fishGroupMin, scene.fishGroupMax);
+            float spawnX = camera.Position.x + (spawnRandom.nextFloat() - 0.5f) * 100.0f;
+            float spawnZ = camera.Position.z + (spawnRandom.nextFloat() - 0.5f) * 100.0f;
+            float spawnY = -9.0f + (spawnRandom.nextFloat() * 6.0f);
             glm::vec3 center(spawnX, spawnY, spawnZ);
-            glm::vec3 dir((rand() / (float)RAND_MAX - 0.5f) * 0.4f, (rand() / (float)RAND_MAX - 0.5f) * 0.2f, -0.6f + (rand() / (float)RAND_MAX) * 1.2f);
-            dir = glm::normalize(dir);
+            float dirX = (spawnRandom.nextFloat() - 0.5f) * 0.4f;
+            float dirY = (spawnRandom.nextFloat() - 0.5f) * 0.2f;
+            float dirZ = -0.6f + spawnRandom.nextFloat() * 1.2f;
+            glm::vec3 dir = glm::normalize(glm::vec3(dirX, dirY, dirZ));
             float yawBase = std::atan2(dir.x, dir.z);
             for (int i = 0; i < groupSize; ++i) {
-                glm::vec3 offset((rand() / (float)RAND_MAX - 0.5f) * 6.0f, (rand() / (float)RAND_MAX - 0.5f) * 2.0f, (rand() / (float)RAND_MAX - 0.5f) * 6.0f);
+                float offsetX = (spawnRandom.nextFloat() - 0.5f) * 6.0f;
+                float offsetY = (spawnRandom.nextFloat() - 0.5f) * 2.0f;
+                float offsetZ = (spawnRandom.nextFloat() - 0.5f) * 6.0f;
+                glm::vec3 offset(offsetX, offsetY, offsetZ);
                 glm::vec3 pos = center + offset;
                 pos.y = std::min(pos.y, MAX_FISH_HEIGHT);
-                list.push_back({ pos, dir, yawBase });
+                fishSystem.add(pos, dir, yawBase);
             }
         }
-        fishInstances[static_cast<int>(t)] = std::move(list);
     }
+    std::cout << "INFO: Ryby: " << fishSystem.size() << ", kernel " << FishSystem::kernelName() << std::endl;
+
+    //ryby na GPU: snapshot wysylany co klatke, gatunek = jedna komenda
+    GpuInstanceSet* fishGpu = nullptr;
+    std::vector<GpuDrawGroup> fishGroups(fishTypes.size());
+    if (gpuCullingSupported)
+        fishGpu = new GpuInstanceSet(*cullShader, 1, fishSystem.size(), static_cast<int>(fishTypes.size()));
+
+    //symulacja ryb i babelkow na puli watkow, render czyta tylko snapshoty
+    SimulationSettings simSettings;
+    simSettings.fishSpeed = fishGlobalSpeed;
+    simSettings.maxBubbleHeight = MAX_BUBBLE_HEIGHT;
+    Simulation simulation(jobs, fishSystem, bubbles, simSettings, rootRandom.stream(2));
 
 	//konfiguracja FBO i tekstury dla post-processingu
     glGenFramebuffers(1, &framebuffer);
@@ -293,6 +515,24 @@ int main()
         std::cerr << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
+    //bez okna post-processing trafia do osobnego FBO, z ktorego czytamy klatki
+    unsigned int presentFramebuffer = 0;
+    unsigned int presentTexture = 0;
+    if (headless) {
+        glGenFramebuffers(1, &presentFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, presentFramebuffer);
+        glGenTextures(1, &presentTexture);
+        glBindTexture(GL_TEXTURE_2D, presentTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, SCR_WIDTH, SCR_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, presentTexture, 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cerr << "ERROR::FRAMEBUFFER:: Present framebuffer is not complete!" << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (!framesOut.empty()) std::filesystem::create_directories(framesOut);
+    }
+
     //konfiguracja VAO/VBO dla kwadratu post-processingu 
     glGenVertexArrays(1, &quadVAO);
     glGenBuffers(1, &quadVBO);
@@ -305,18 +545,151 @@ int main()
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
     glBindVertexArray(0);
 
+    //bufor instancji ryb, wypelniany co klatke
+    StreamBuffer fishInstanceBuffer(4 * 1024 * 1024);
+    //bufor widocznych instancji roslin (po cullingu)
+    StreamBuffer plantInstanceBuffer(4 * 1024 * 1024);
+    std::vector<int> visiblePlants;
+    std::vector<int> instanceLods;
+    std::vector<glm::vec4> visibleFish;
+    //impostory dalekich instancji (klawisz I)
+    bool impostorsEnabled = true;
+    bool impostorKeyWasDown = false;
+    UniformHandle impostorAmbientLoc = impostorShader.uniform("ambientStrength");
+
+    //frustum culling - klawisz C, liczniki w tytule okna
+    bool cullingEnabled = true;
+    bool cullKeyWasDown = false;
+    //culling na GPU (klawisz G), gdy kontekst ma GL 4.3
+    bool gpuCulling = gpuCullingSupported;
+    bool gpuKeyWasDown = false;
+    float statsTitleTime = 0.0f;
+    //profiler etapow klatki - klawisz P wypisuje min/avg/p99; benchmark trzyma wszystkie mierzone klatki
+    Profiler profiler(true, benchmark ? std::max(benchmarkFrames, PROFILER_HISTORY) : PROFILER_HISTORY);
+    bool profilerKeyWasDown = false;
+    bool traceKeyWasDown = false;
+
+    //uniformy ustawiane w petlach - lokacje pobrane raz
+    UniformHandle bubbleModelLoc = bubbleShader.uniform("model");
+    UniformHandle plantBaseColorLoc = plantShader.uniform("baseColor");
+    UniformHandle fishTextureLoc = fishShader.uniform("texture_diffuse1");
+    UniformHandle fishUvScaleLoc = fishShader.uniform("uvScale");
+    UniformHandle fishUvOffsetLoc = fishShader.uniform("uvOffset");
+    UniformHandle fishYawOffsetLoc = fishShader.uniform("yawOffset");
+    UniformHandle fishScaleLoc = fishShader.uniform("fishScale");
+
     std::cout << "INFO: Inicjalizacja zakonczona. Wchodze do glownej petli..." << std::endl;
 
+    //benchmark: zapis konfiguracji i liczniki mierzonych klatek
+    BenchmarkConfig benchmarkConfig;
+    benchmarkConfig.seed = seed;
+    benchmarkConfig.warmupFrames = benchmarkWarmup;
+    benchmarkConfig.measuredFrames = benchmarkFrames;
+    benchmarkConfig.width = SCR_WIDTH;
+    benchmarkConfig.height = SCR_HEIGHT;
+    benchmarkConfig.glVersion = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    benchmarkConfig.renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    benchmarkConfig.cameraPath = cameraPathFile.empty() ? "flythrough" : cameraPathFile;
+    benchmarkConfig.culling = cullingEnabled ? (gpuCulling ? "gpu" : "cpu") : "off";
+    benchmarkConfig.scene = scene;
+    benchmarkConfig.fishCount = fishSystem.size();
+    for (const PlantType& type : plantTypes) benchmarkConfig.plantCount += type.instanceCount;
+    BenchmarkCounters benchmarkCounters;
+    CameraPath recordedPath;
+    float recordTime = -1.0f;
+
     //glowna petla
-    while (!glfwWindowShouldClose(window)) {
+    //bez okna i w benchmarku: stala klatka 1/60 s, zeby seria klatek byla powtarzalna
+    const float FIXED_FRAME_TIME = 1.0f / 60.0f;
+    benchmarkConfig.frameTime = FIXED_FRAME_TIME;
+    bool fixedStep = headless || benchmark;
+    int frameLimit = benchmark ? benchmarkWarmup + benchmarkFrames : (headless ? headlessFrames : 0);
+    int frameIndex = 0;
+    std::vector<unsigned char> frameRGB;
+    double cpuFrameMsTotal = 0.0, cpuFrameMsMax = 0.0;
+    while ((frameLimit == 0 || frameIndex < frameLimit) && (!window || !glfwWindowShouldClose(window))) {
+        auto cpuFrameStart = std::chrono::high_resolution_clock::now();
+        if (benchmark && frameIndex == benchmarkWarmup) {
+            profiler.reset();
+            std::cout << "INFO: Benchmark - rozgrzewka zakonczona, pomiar " << benchmarkFrames << " klatek" << std::endl;
+        }
+        profiler.beginFrame();
 
-        float currentFrame = static_cast<float>(glfwGetTime());
+        float currentFrame = fixedStep ? (frameIndex + 1) * FIXED_FRAME_TIME : static_cast<float>(glfwGetTime());
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        camera.Inputs(window, deltaTime);
-        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        //w benchmarku klawisze nie zmieniaja sceny - tylko ESC przerywa
+        if (window && benchmark && glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
             glfwSetWindowShouldClose(window, true);
+        if (window && !benchmark) {
+            ProfileScope profile(profiler, "input", false);
+            camera.Inputs(window, deltaTime);
+            if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+                glfwSetWindowShouldClose(window, true);
+            bool fftKeyDown = glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS;
+            if (fftKeyDown && !fftKeyWasDown) {
+                oceanFFTMode = !oceanFFTMode;
+                std::cout << "INFO: Ocean: " << (oceanFFTMode ? "FFT" : "Gerstner") << std::endl;
+            }
+            fftKeyWasDown = fftKeyDown;
+            bool cullKeyDown = glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS;
+            if (cullKeyDown && !cullKeyWasDown) {
+                cullingEnabled = !cullingEnabled;
+                std::cout << "INFO: Frustum culling: " << (cullingEnabled ? "wlaczony" : "wylaczony") << std::endl;
+            }
+            cullKeyWasDown = cullKeyDown;
+            bool gpuKeyDown = glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS;
+            if (gpuKeyDown && !gpuKeyWasDown && gpuCullingSupported) {
+                gpuCulling = !gpuCulling;
+                std::cout << "INFO: Culling roslin i ryb: " << (gpuCulling ? "GPU" : "CPU") << std::endl;
+            }
+            gpuKeyWasDown = gpuKeyDown;
+            bool impostorKeyDown = glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS;
+            if (impostorKeyDown && !impostorKeyWasDown) {
+                impostorsEnabled = !impostorsEnabled;
+                std::cout << "INFO: Impostory: " << (impostorsEnabled ? "wlaczone" : "wylaczone") << std::endl;
+            }
+            impostorKeyWasDown = impostorKeyDown;
+            bool profilerKeyDown = glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS;
+            if (profilerKeyDown && !profilerKeyWasDown)
+                profiler.report(std::cout);
+            profilerKeyWasDown = profilerKeyDown;
+            bool traceKeyDown = glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS;
+            if (traceKeyDown && !traceKeyWasDown && !traceEnabled()) {
+                std::cout << "INFO: Zapis sladu " << traceFrames << " klatek..." << std::endl;
+                traceStart();
+                traceFramesLeft = traceFrames;
+            }
+            traceKeyWasDown = traceKeyDown;
+        }
+        bool gpuPath = gpuCulling && cullingEnabled;
+
+        //kamera z sciezki zamiast z klawiatury i myszy
+        if (benchmark) {
+            CameraKey pose = cameraPath.sample(currentFrame);
+            camera.setPose(pose.position, pose.yaw, pose.pitch);
+        }
+        if (!recordPathFile.empty() && !benchmark && currentFrame - recordTime >= 0.25f) {
+            if (recordTime < 0.0f) recordTime = currentFrame;
+            float time = recordedPath.keys.empty() ? 0.0f : recordedPath.keys.back().time + (currentFrame - recordTime);
+            recordedPath.keys.push_back({ time, camera.Position, camera.yaw, camera.pitch });
+            recordTime = currentFrame;
+        }
+
+        //krok N-1 gotowy -> snapshot do renderu, krok N startuje w tle
+        {
+            //czas czekania na poprzedni krok symulacji
+            ProfileScope profile(profiler, "simulation", false);
+            simulation.beginFrame(deltaTime, camera.Position.z);
+        }
+        const SimulationSnapshot& sim = simulation.snapshot();
+
+        //symulacja FFT przed wlasciwym renderem (wlasne FBO)
+        if (oceanFFTMode) {
+            ProfileScope profile(profiler, "ocean_fft");
+            oceanFFT.update(currentFrame);
+        }
 
         //rendere sceny do FBO
         glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
@@ -324,177 +697,420 @@ int main()
         glClearColor(0.1f, 0.2f, 0.4f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glm::mat4 view = camera.getViewMatrix();
-        glm::mat4 projection = camera.getProjectionMatrix();
+        FrameData frameData = {};
+        frameData.view = camera.getViewMatrix();
+        frameData.projection = camera.getProjectionMatrix();
+        frameData.viewPos = camera.Position;
+        frameData.time = currentFrame;
+        frameData.lightPos = lightPos;
+        frameData.lightColor = lightColor;
+        frameUniforms.update(frameData);
+
+        Frustum frustum = extractFrustum(frameData.projection * frameData.view);
+        CullStats plantStats, fishStats, bubbleStats;
+        //LOD z rozmiaru sfery na ekranie: promien * projection[1][1] / odleglosc
+        float lodScale = frameData.projection[1][1];
+        long long trianglesDrawn = 0;
+        int drawCalls = 0;
 
         //skybox
-        glDepthMask(GL_FALSE);
-        skyboxShader.Activate();
-        skyboxShader.setMat4("view", glm::mat4(glm::mat3(view)));
-        skyboxShader.setMat4("projection", projection);
-        skyboxShader.setInt("skybox", 0);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-        glBindVertexArray(skyboxVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-        glBindVertexArray(0);
-        glDepthMask(GL_TRUE);
+        {
+            ProfileScope profile(profiler, "skybox");
+            glDepthMask(GL_FALSE);
+            skyboxShader.Activate();
+            skyboxShader.setInt("skybox", 0);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
+            glBindVertexArray(skyboxVAO);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+            drawCalls++;
+            glBindVertexArray(0);
+            glDepthMask(GL_TRUE);
+        }
 
         //piasek
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, groundTexture);
-        groundShader.use();
-        groundShader.setInt("texture_diffuse1", 0);
-        groundShader.setFloat("texScale", 1.0f);
-        groundShader.setVec3("fogColor", glm::vec3(0.0, 0.0, 0.0));
-        groundShader.setFloat("fogDensity", 0.0f);
-        groundShader.setFloat("ambientStrength", 1.0f);
-        glm::mat4 groundModel = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -10.0f, 0.0f));
-        groundShader.setMat4("model", groundModel);
-        groundShader.setMat4("view", view);
-        groundShader.setMat4("projection", projection);
-        groundShader.setVec3("lightPos", lightPos);
-        groundShader.setVec3("lightColor", lightColor);
-        groundShader.setVec3("viewPos", camera.Position);
-        glBindVertexArray(groundVAO);
-        glDrawElements(GL_TRIANGLES, groundIndexCount, GL_UNSIGNED_INT, 0);
+        {
+            ProfileScope profile(profiler, "ground");
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, groundTexture);
+            groundShader.use();
+            groundShader.setInt("texture_diffuse1", 0);
+            groundShader.setFloat("texScale", 1.0f);
+            groundShader.setVec3("fogColor", glm::vec3(0.0, 0.0, 0.0));
+            groundShader.setFloat("fogDensity", 0.0f);
+            groundShader.setFloat("ambientStrength", 1.0f);
+            glm::mat4 groundModel = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -10.0f, 0.0f));
+            groundShader.setMat4("model", groundModel);
+            glBindVertexArray(groundVAO);
+            glDrawElements(GL_TRIANGLES, groundIndexCount, GL_UNSIGNED_INT, 0);
+            drawCalls++;
+        }
 
         //blending przed renderowaniem oceanu i babelkow
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         //ocean
-        oceanShader.Activate();
-        oceanShader.setMat4("projection", projection);
-        oceanShader.setMat4("view", view);
-        oceanShader.setMat4("model", glm::mat4(1.0f));
-        oceanShader.setFloat("time", currentFrame);
-        oceanShader.setVec3("viewPos", camera.Position);
-        oceanShader.setVec3("lightPos", lightPos);
-        oceanShader.setVec3("lightColor", lightColor); 
-        oceanShader.setInt("skybox", 0); 
-        glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-        glBindVertexArray(oceanVAO);
-        glDrawElements(GL_TRIANGLES, oceanIndexCount, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+        {
+            ProfileScope profile(profiler, "ocean");
+            oceanShader.Activate();
+            oceanShader.setMat4("model", glm::mat4(1.0f));
+            oceanShader.setInt("skybox", 0); 
+            oceanShader.setBool("fftMode", oceanFFTMode);
+            glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
+            if (oceanFFTMode) {
+                glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, oceanFFT.displacementTexture());
+                glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, oceanFFT.normalTexture());
+                glActiveTexture(GL_TEXTURE0);
+            }
+            oceanClipmap.draw(oceanShader, camera.Position);
+            drawCalls += oceanClipmap.params().levels;
+        }
 
 
         //render babelkow
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture); 
-        bubbleShader.use();
-        bubbleShader.setMat4("view", view);
-        bubbleShader.setMat4("projection", projection);
-        bubbleShader.setVec3("bubbleColor", glm::vec3(0.8f, 0.9f, 1.0f));
-
-        glBindVertexArray(bubbleVAO);
-        for (BubbleInstance& b : bubbles) {
-            b.position.y += b.speed * deltaTime * 60.0f;
-            if (b.position.y > MAX_BUBBLE_HEIGHT) {
-                b.position = glm::vec3((rand() / (float)RAND_MAX - 0.5f) * 300.0f, -10.0f - ((rand() / (float)RAND_MAX) * 10.0f), (rand() / (float)RAND_MAX - 0.5f) * 300.0f);
-                b.speed = 0.1f + ((rand() / (float)RAND_MAX) * 0.1f);
-                b.scale = 0.0001f + ((rand() / (float)RAND_MAX) * 0.1f);
+        {
+            ProfileScope profile(profiler, "bubbles");
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture); 
+            bubbleShader.use();
+            bubbleShader.setVec3("bubbleColor", glm::vec3(0.8f, 0.9f, 1.0f));
+
+            for (const glm::mat4& model : sim.bubbleModels) {
+                glm::vec3 center = glm::vec3(model * glm::vec4(bubbleMesh.boundsCenter, 1.0f));
+                float radius = bubbleMesh.boundsRadius * glm::length(glm::vec3(model[0]));
+                if (cullingEnabled && !sphereInFrustum(frustum, center, radius)) continue;
+                int lod = instanceLod(bubbleMesh, center, radius, camera.Position, lodScale, false);
+                bubbleStats.visible++;
+                trianglesDrawn += bubbleMesh.lods[lod].indexCount / 3;
+                bubbleShader.setMat4(bubbleModelLoc, model);
+                bubbleMesh.draw(lod);
+                drawCalls++;
+            }
+            bubbleStats.tested = static_cast<int>(sim.bubbleModels.size());
+        }
+
+        //render roslin - jeden draw call na typ, tylko widoczne instancje
+        {
+            ProfileScope profile(profiler, "plants");
+            if (gpuPath) {
+                //liczby widocznych zna tylko GPU - CPU wysyla komendy, nie listy instancji
+                plantGpu->cull(frustum, camera.Position, lodScale, plantGroups.data(), static_cast<int>(plantGroups.size()),
+                    impostorsEnabled);
+                plantShader.use();
+                for (size_t t = 0; t < plantTypes.size(); ++t) {
+                    const PlantType& type = plantTypes[t];
+                    plantStats.tested += type.instanceCount;
+                    if (type.instanceCount == 0) continue;
+                    plantGpu->bindAttributes(type.mesh, 3);
+                    plantShader.setVec3(plantBaseColorLoc, type.color);
+                    plantGpu->draw(type.mesh, static_cast<int>(t));
+                    drawCalls += type.mesh.lodCount;
+                    if (impostorsEnabled && type.impostor.valid()) {
+                        impostorShader.Activate();
+                        impostorShader.setFloat(impostorAmbientLoc, 0.4f);
+                        plantGpu->drawImpostors(type.impostor, impostorShader, static_cast<int>(t));
+                        drawCalls++;
+                        plantShader.use();
+                    }
+                }
             }
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(0.0f, -1.0f, 0.0f));
-            model = glm::scale(model, glm::vec3(b.scale));
-            model = glm::rotate(model, glm::radians(180.0f), glm::vec3(1, 0, 0));
-            model = glm::translate(model, b.position);
-            bubbleShader.setMat4("model", model);
-            glDrawArrays(GL_TRIANGLES, 0, bubbleCount);
-        }
-
-        //render roslin 
-        for (size_t t = 0; t < plantTypes.size(); ++t) {
-            const PlantType& type = plantTypes[t];
-            glBindVertexArray(type.vao);
             plantShader.use();
-            plantShader.setMat4("view", view);
-            plantShader.setMat4("projection", projection);
-            plantShader.setVec3("lightPos", lightPos);
-            plantShader.setVec3("lightColor", lightColor);
-            plantShader.setVec3("viewPos", camera.Position);
-            plantShader.setVec3("baseColor", type.color);
-            for (const PlantInstance& p : plantInstances[t]) {
-                glm::mat4 model = glm::mat4(1.0f);
-                model = glm::translate(model, p.position);
-                model = glm::rotate(model, p.yaw, glm::vec3(0.0f, 1.0f, 0.0f));
-                if (type.vao == pinkVAO) model = glm::rotate(model, glm::radians(360.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-                else model = glm::rotate(model, glm::radians(270.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-                model = glm::scale(model, glm::vec3(p.scale));
-                plantShader.setMat4("model", model);
-                glDrawArrays(GL_TRIANGLES, 0, type.vertexCount);
+            for (const PlantType& type : plantTypes) {
+                if (gpuPath || type.instanceCount == 0) continue;
+                int visibleCount = type.instanceCount;
+                visiblePlants.resize(type.instanceCount);
+                if (cullingEnabled) {
+                    visibleCount = type.bvh.cullFrustum(frustum, visiblePlants.data());
+                }
+                else {
+                    for (int k = 0; k < visibleCount; ++k) visiblePlants[k] = k;
+                }
+                plantStats.add(type.instanceCount, visibleCount);
+                if (visibleCount == 0) continue;
+
+                //widoczne kubelkowane po LOD - jeden draw call na poziom
+                const SphereBVH& bvh = type.bvh;
+                instanceLods.resize(visibleCount);
+                for (int k = 0; k < visibleCount; ++k) {
+                    int slot = visiblePlants[k];
+                    glm::vec3 center(bvh.sortedX[slot], bvh.sortedY[slot], bvh.sortedZ[slot]);
+                    instanceLods[k] = instanceLod(type.mesh, center, bvh.sortedR[slot], camera.Position, lodScale,
+                        impostorsEnabled && type.impostor.valid());
+                }
+                int lodStart[LOD_BUCKETS + 1];
+                countLods(instanceLods.data(), visibleCount, lodStart);
+
+                GLintptr instanceOffset = 0;
+                glm::mat4* gpu = static_cast<glm::mat4*>(plantInstanceBuffer.map(visibleCount * sizeof(glm::mat4), instanceOffset));
+                int cursor[LOD_BUCKETS];
+                std::copy(lodStart, lodStart + LOD_BUCKETS, cursor);
+                for (int k = 0; k < visibleCount; ++k)
+                    gpu[cursor[instanceLods[k]]++] = type.models[visiblePlants[k]];
+                plantInstanceBuffer.unmap();
+
+                plantShader.setVec3(plantBaseColorLoc, type.color);
+                for (int l = 0; l < type.mesh.lodCount; ++l) {
+                    int lodCount = lodStart[l + 1] - lodStart[l];
+                    if (lodCount == 0) continue;
+                    bindPlantInstances(type, plantInstanceBuffer.ID, instanceOffset + lodStart[l] * sizeof(glm::mat4));
+                    type.mesh.drawInstanced(lodCount, l);
+                    drawCalls++;
+                    trianglesDrawn += (long long)lodCount * (type.mesh.lods[l].indexCount / 3);
+                }
+                int impostorCount = lodStart[IMPOSTOR_BUCKET + 1] - lodStart[IMPOSTOR_BUCKET];
+                if (impostorCount > 0) {
+                    impostorShader.Activate();
+                    impostorShader.setFloat(impostorAmbientLoc, 0.4f);
+                    type.impostor.draw(impostorShader, plantInstanceBuffer.ID,
+                        instanceOffset + lodStart[IMPOSTOR_BUCKET] * sizeof(glm::mat4), impostorCount);
+                    trianglesDrawn += 2 * impostorCount;
+                    drawCalls++;
+                    plantShader.use();
+                }
             }
+            glBindVertexArray(0);
         }
-        glBindVertexArray(0);
 
         //render ryb
-        fishShader.Activate();
-        fishShader.setMat4("projection", projection);
-        fishShader.setMat4("view", view);
-        fishShader.setVec3("viewPos", camera.Position);
-        fishShader.setVec3("lightPos", lightPos);
-        fishShader.setVec3("lightColor", lightColor);
-        for (size_t t = 0; t < fishTypes.size(); ++t) {
-            const FishType& type = fishTypes[t];
-            glBindVertexArray(type.vao);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, type.texture);
-            fishShader.setInt("texture_diffuse1", 0);
-            auto& list = fishInstances[static_cast<int>(t)];
-            for (FishInstance& fish : list) {
-                fish.position += fish.velocity * fishGlobalSpeed * type.speed * deltaTime * 60.0f;
-                if (fish.position.y > MAX_FISH_HEIGHT) {
-                    fish.position.y = MAX_FISH_HEIGHT;
-                    fish.velocity.y = std::min(fish.velocity.y, 0.0f);
+        {
+            ProfileScope profile(profiler, "fish");
+            if (gpuPath) {
+                for (size_t t = 0; t < fishTypes.size(); ++t) {
+                    const FishType& type = fishTypes[t];
+                    float radius = (glm::length(type.mesh.boundsCenter) + type.mesh.boundsRadius) * type.scale;
+                    fishGroups[t] = { &type.mesh, sim.speciesFirst[t], sim.speciesCount[t], radius,
+                        &type.impostor, type.yawOffset + glm::radians(180.0f), type.scale };
+                    fishStats.tested += sim.speciesCount[t];
+                }
+                if (!sim.fish.empty())
+                    fishGpu->upload(&sim.fish[0].positionYaw, nullptr, static_cast<int>(sim.fish.size()), true);
+                fishGpu->cull(frustum, camera.Position, lodScale, fishGroups.data(), static_cast<int>(fishGroups.size()),
+                    impostorsEnabled);
+            }
+            fishShader.Activate();
+            for (size_t t = 0; t < fishTypes.size(); ++t) {
+                const FishType& type = fishTypes[t];
+                int count = sim.speciesCount[t];
+                if (count == 0) continue;
+
+                if (gpuPath) {
+                    fishGpu->bindAttributes(type.mesh, 3);
+                    glActiveTexture(GL_TEXTURE0);
+                    glBindTexture(GL_TEXTURE_2D, type.texture);
+                    fishShader.setInt(fishTextureLoc, 0);
+                    fishShader.setVec2(fishUvScaleLoc, type.uvScale);
+                    fishShader.setVec2(fishUvOffsetLoc, type.uvOffset);
+                    fishShader.setFloat(fishYawOffsetLoc, type.yawOffset + glm::radians(180.0f));
+                    fishShader.setFloat(fishScaleLoc, type.scale);
+                    fishGpu->draw(type.mesh, static_cast<int>(t));
+                    drawCalls += type.mesh.lodCount;
+                    if (impostorsEnabled && type.impostor.valid()) {
+                        impostorShader.Activate();
+                        impostorShader.setFloat(impostorAmbientLoc, 0.3f);
+                        fishGpu->drawImpostors(type.impostor, impostorShader, static_cast<int>(t));
+                        drawCalls++;
+                        fishShader.Activate();
+                    }
+                    continue;
+                }
+
+                //widoczne kompaktowane do bufora roboczego, potem kubelkowane po LOD
+                const FishInstanceGPU* source = &sim.fish[sim.speciesFirst[t]];
+                //ryba obraca sie wokol poczatku ukladu modelu - sfera musi go objac
+                float radius = (glm::length(type.mesh.boundsCenter) + type.mesh.boundsRadius) * type.scale;
+                int visibleCount = count;
+                visibleFish.resize(count);
+                if (cullingEnabled) {
+                    visibleCount = cullInstances(frustum, &source->positionYaw, count, radius, visibleFish.data());
                 }
-                if (fish.position.z < DESPAWN_Z) {
-                    fish.position.x = (rand() / (float)RAND_MAX - 0.5f) * 2.0f * SPAWN_RADIUS_XZ;
-                    fish.position.y = -9.0f + ((rand() / (float)RAND_MAX) * 6.0f);
-                    fish.position.z = camera.Position.z - SPAWN_Z_OFFSET - ((rand() / (float)RAND_MAX) * 10.0f);
+                else {
+                    for (int k = 0; k < count; ++k) visibleFish[k] = source[k].positionYaw;
+                }
+                fishStats.add(count, visibleCount);
+                if (visibleCount == 0) continue;
+
+                instanceLods.resize(visibleCount);
+                for (int k = 0; k < visibleCount; ++k)
+                    instanceLods[k] = instanceLod(type.mesh, glm::vec3(visibleFish[k]), radius, camera.Position, lodScale,
+                        impostorsEnabled && type.impostor.valid());
+                int lodStart[LOD_BUCKETS + 1];
+                countLods(instanceLods.data(), visibleCount, lodStart);
+
+                //impostory potrzebuja pelnych macierzy model - jedna rezerwacja na oba zakresy,
+                //bo drugie map() moglo osierocic bufor i uniewaznic instanceOffset
+                int impostorCount = lodStart[IMPOSTOR_BUCKET + 1] - lodStart[IMPOSTOR_BUCKET];
+                size_t vec4Bytes = visibleCount * sizeof(FishInstanceGPU);
+                size_t matrixStart = (vec4Bytes + sizeof(glm::mat4) - 1) / sizeof(glm::mat4) * sizeof(glm::mat4);
+                size_t mapBytes = impostorCount > 0 ? matrixStart + impostorCount * sizeof(glm::mat4) : vec4Bytes;
+
+                GLintptr instanceOffset = 0;
+                char* mapped = static_cast<char*>(fishInstanceBuffer.map(mapBytes, instanceOffset));
+                glm::vec4* gpu = reinterpret_cast<glm::vec4*>(mapped);
+                int cursor[LOD_BUCKETS];
+                std::copy(lodStart, lodStart + LOD_BUCKETS, cursor);
+                for (int k = 0; k < visibleCount; ++k)
+                    gpu[cursor[instanceLods[k]]++] = visibleFish[k];
+                GLintptr impostorOffset = instanceOffset + matrixStart;
+                if (impostorCount > 0) {
+                    glm::mat4* matrices = reinterpret_cast<glm::mat4*>(mapped + matrixStart);
+                    int n = 0;
+                    for (int k = 0; k < visibleCount; ++k)
+                        if (instanceLods[k] == IMPOSTOR_BUCKET) matrices[n++] = fishModelMatrix(visibleFish[k], type);
+                }
+                fishInstanceBuffer.unmap();
+
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, type.texture);
+                fishShader.setInt(fishTextureLoc, 0);
+                fishShader.setVec2(fishUvScaleLoc, type.uvScale);
+                fishShader.setVec2(fishUvOffsetLoc, type.uvOffset);
+                fishShader.setFloat(fishYawOffsetLoc, type.yawOffset + glm::radians(180.0f));
+                fishShader.setFloat(fishScaleLoc, type.scale);
+
+                glBindVertexArray(type.mesh.vao);
+                glBindBuffer(GL_ARRAY_BUFFER, fishInstanceBuffer.ID);
+                glEnableVertexAttribArray(3);
+                glVertexAttribDivisor(3, 1);
+                for (int l = 0; l < type.mesh.lodCount; ++l) {
+                    int lodCount = lodStart[l + 1] - lodStart[l];
+                    if (lodCount == 0) continue;
+                    GLintptr lodOffset = instanceOffset + lodStart[l] * sizeof(FishInstanceGPU);
+                    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(FishInstanceGPU), (void*)lodOffset);
+                    type.mesh.drawInstanced(lodCount, l);
+                    drawCalls++;
+                    trianglesDrawn += (long long)lodCount * (type.mesh.lods[l].indexCount / 3);
+                }
+                if (impostorCount > 0) {
+                    impostorShader.Activate();
+                    impostorShader.setFloat(impostorAmbientLoc, 0.3f);
+                    type.impostor.draw(impostorShader, fishInstanceBuffer.ID, impostorOffset, impostorCount);
+                    trianglesDrawn += 2 * impostorCount;
+                    drawCalls++;
+                    fishShader.Activate();
                 }
-                glm::vec2 uvScale(1.0f), uvOffset(0.0f);
-                if (type.texture == fishTexture1) { uvScale = glm::vec2(1.0f, 0.5f); uvOffset = glm::vec2(0.0f, 0.5f); }
-                else if (type.texture == fishTexture2) { uvScale = glm::vec2(1.0f, 1.0f); uvOffset = glm::vec2(0.0f, 0.0f); }
-                fishShader.setVec2("uvScale", uvScale);
-                fishShader.setVec2("uvOffset", uvOffset);
-                glm::mat4 model = glm::mat4(1.0f);
-                model = glm::translate(model, fish.position);
-                model = glm::rotate(model, fish.yaw + type.yawOffset + glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-                model = glm::scale(model, glm::vec3(type.scale));
-                fishShader.setMat4("model", model);
-                glDrawArrays(GL_TRIANGLES, 0, type.vertexCount);
             }
+            glBindVertexArray(0);
+            // glDisable(GL_BLEND);
         }
-        glBindVertexArray(0);
-        // glDisable(GL_BLEND);
 
+        if (benchmark && frameIndex >= benchmarkWarmup) {
+            benchmarkCounters.drawCalls.add(drawCalls);
+            benchmarkCounters.simulationMs.add(simulation.lastStepMs());
+            if (!gpuPath) benchmarkCounters.triangles.add(static_cast<double>(trianglesDrawn));
+        }
+        if (traceEnabled()) {
+            traceCounter("draw calls", drawCalls);
+            //przy cullingu na GPU liczby widocznych zna tylko GPU
+            if (!gpuPath) {
+                traceCounter("triangles", static_cast<double>(trianglesDrawn));
+                traceCounter("instances", plantStats.visible + fishStats.visible + bubbleStats.visible);
+            }
+        }
 
-        //render ramki do domyuslnego bufora
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glDisable(GL_DEPTH_TEST);
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        //widoczne / testowane w tytule okna, co pol sekundy
+        if (window && currentFrame - statsTitleTime > 0.5f) {
+            statsTitleTime = currentFrame;
+            std::string plantVisible = gpuPath ? "gpu" : std::to_string(plantStats.visible);
+            std::string fishVisible = gpuPath ? "gpu" : std::to_string(fishStats.visible);
+            std::string title = "OceanGL | rosliny " + plantVisible + "/" + std::to_string(plantStats.tested)
+                + " | ryby " + fishVisible + "/" + std::to_string(fishStats.tested)
+                + " | babelki " + std::to_string(bubbleStats.visible) + "/" + std::to_string(bubbleStats.tested)
+                + " | culling " + (cullingEnabled ? (gpuPath ? "GPU" : "CPU") : "wyl")
+                + " | trojkaty " + (gpuPath ? std::string("gpu") : std::to_string(trianglesDrawn / 1000) + "k")
+                + " | klatka " + std::to_string(profiler.frameStats().avg).substr(0, 5) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
 
-        postProcessShader.use();
-        glBindVertexArray(quadVAO);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureColorbuffer);
-        postProcessShader.setInt("screenTexture", 0); 
 
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        //render ramki do domyuslnego bufora (bez okna - do presentFramebuffer)
+        {
+            ProfileScope profile(profiler, "postprocess");
+            glBindFramebuffer(GL_FRAMEBUFFER, presentFramebuffer);
+            glDisable(GL_DEPTH_TEST);
+            glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            postProcessShader.use();
+            glBindVertexArray(quadVAO);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, textureColorbuffer);
+            postProcessShader.setInt("screenTexture", 0); 
+
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+        }
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        if (window) {
+            ProfileScope profile(profiler, "swap");
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+        else {
+            //czas CPU klatki bez czekania na GPU przy odczycie
+            double cpuMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - cpuFrameStart).count();
+            cpuFrameMsTotal += cpuMs;
+            cpuFrameMsMax = std::max(cpuFrameMsMax, cpuMs);
+            if (!framesOut.empty()) {
+                readFramebuffer(presentFramebuffer, SCR_WIDTH, SCR_HEIGHT, frameRGB);
+                char name[32];
+                std::snprintf(name, sizeof(name), "frame_%04d.ppm", frameIndex);
+                writePPM((std::filesystem::path(framesOut) / name).string(), SCR_WIDTH, SCR_HEIGHT, frameRGB);
+            }
+            else {
+                glFinish();
+            }
+        }
+        profiler.endFrame();
+        frameIndex++;
+        if (traceEnabled() && --traceFramesLeft <= 0) {
+            traceStop();
+            traceWrite(tracePath);
+        }
+    }
+    if (headless && frameIndex > 0)
+        std::cout << "INFO: " << frameIndex << " klatek bez okna, CPU srednio " << cpuFrameMsTotal / frameIndex
+                  << " ms, max " << cpuFrameMsMax << " ms" << std::endl;
+    if (headless || benchmark) profiler.report(std::cout);
+    if (benchmark) {
+        if (frameIndex == frameLimit) {
+            writeBenchmarkReport(benchmarkOut, benchmarkConfig, profiler, benchmarkCounters);
+            if (!sweepRowFile.empty())
+                appendSweepRow(sweepRowFile, sweepRowSubsystem, sweepRowSize, benchmarkConfig, profiler, benchmarkCounters);
+        }
+        else
+            std::cerr << "ERROR: Benchmark przerwany po " << frameIndex << " klatkach - brak raportu" << std::endl;
+    }
+    if (!recordedPath.keys.empty() && recordedPath.save(recordPathFile))
+        std::cout << "INFO: Sciezka kamery (" << recordedPath.keys.size() << " punktow) zapisana do " << recordPathFile << std::endl;
+    if (traceEnabled()) {
+        traceStop();
+        traceWrite(tracePath);
     }
     glDeleteFramebuffers(1, &framebuffer);
     glDeleteTextures(1, &textureColorbuffer);
     glDeleteRenderbuffers(1, &rbo);
     glDeleteVertexArrays(1, &quadVAO);
     glDeleteBuffers(1, &quadVBO);
-
+    if (presentFramebuffer) glDeleteFramebuffers(1, &presentFramebuffer);
+    if (presentTexture) glDeleteTextures(1, &presentTexture);
+    simulation.finish();
+    fishInstanceBuffer.Delete();
+    plantInstanceBuffer.Delete();
+    if (plantGpu) { plantGpu->Delete(); delete plantGpu; }
+    if (fishGpu) { fishGpu->Delete(); delete fishGpu; }
+    if (cullShader) { cullShader->Delete(); delete cullShader; }
+    for (PlantType& type : plantTypes) type.impostor.Delete();
+    for (FishType& type : fishTypes) type.impostor.Delete();
+    impostorShader.Delete();
+    profiler.Delete();
+    frameUniforms.Delete();
+    oceanFFT.Delete();
+    oceanClipmap.Delete();
+
+    headlessContext.Delete();
     glfwTerminate();
-    return 0;
+    //przerwany benchmark konczy sie bledem (--sweep oznacza go jako nieudany)
+    return (benchmark && frameIndex != frameLimit) ? 1 : 0;
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
@@ -516,149 +1132,68 @@ void mouse_callback_wrapper(GLFWwindow* window, double xpos, double ypos) {
     camera.MouseCallback(window, xpos, ypos);
 }
 
-unsigned int loadTexture(const char* path) {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    stbi_set_flip_vertically_on_load(true);
-    int width, height, nrComponents;
-    unsigned char* data = stbi_load(path, &width, &height, &nrComponents, 0);
-    std::cout << "INFO: Texture " << path << " loaded with " << nrComponents << " channel(s)." << std::endl;
-    if (data) {
-        GLenum format = GL_RGB;
-        if (nrComponents == 1) format = GL_RED;
-        else if (nrComponents == 3) format = GL_RGB;
-        else if (nrComponents == 4) format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        stbi_image_free(data);
-        std::cout << "INFO: Texture loaded: " << path << std::endl;
-    }
-    else {
-        std::cerr << "ERROR: Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
-        return 0;
+//macierze model i BVH liczone raz; wywolac ponownie tylko gdy zmieni sie zbior instancji
+void buildPlantInstances(PlantType& type, const std::vector<PlantInstance>& instances) {
+    std::vector<glm::mat4> models;
+    std::vector<float> sphereX, sphereY, sphereZ, sphereR;
+    models.reserve(instances.size());
+    for (const PlantInstance& p : instances) {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, p.position);
+        model = glm::rotate(model, p.yaw, glm::vec3(0.0f, 1.0f, 0.0f));
+        model = glm::rotate(model, type.tilt, glm::vec3(1.0f, 0.0f, 0.0f));
+        model = glm::scale(model, glm::vec3(p.scale));
+        models.push_back(model);
+
+        glm::vec3 center = glm::vec3(model * glm::vec4(type.mesh.boundsCenter, 1.0f));
+        sphereX.push_back(center.x);
+        sphereY.push_back(center.y);
+        sphereZ.push_back(center.z);
+        sphereR.push_back(type.mesh.boundsRadius * p.scale);
     }
-    return textureID;
-}
-
-unsigned int loadCubemap(std::vector<std::string> faces) {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(false);
-
+    type.instanceCount = static_cast<int>(models.size());
+    type.bvh.build(sphereX.data(), sphereY.data(), sphereZ.data(), sphereR.data(), type.instanceCount);
 
-    for (unsigned int i = 0; i < faces.size(); i++) {
-        unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-        if (data) {
-            GLenum format = GL_RGB;
-            if (nrChannels == 4) format = GL_RGBA;
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            stbi_image_free(data);
-            std::cout << "INFO: Cubemap loaded: " << faces[i] << std::endl;
-        }
-        else {
-            std::cerr << "ERROR: Cubemap texture failed to load at path: " << faces[i] << std::endl;
-            stbi_image_free(data); return 0;
-        }
-    }
-
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-    stbi_set_flip_vertically_on_load(true);
-    return textureID;
+    //macierze w kolejnosci slotow BVH - wynik zapytania indeksuje je bezposrednio
+    type.models.resize(models.size());
+    for (int s = 0; s < type.instanceCount; ++s)
+        type.models[s] = models[type.bvh.order[s]];
 }
 
-bool loadObj(const char* path, std::vector<float>& out_vertices, int& vertex_count, unsigned int& vao, unsigned int& vbo) {
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path)) {
-        std::cerr << "TINYOBJLOADER_ERROR: " << warn << err << std::endl;
-        return false;
+//mat4 zajmuje lokacje 3..6, po jednej kolumnie; offset wskazuje widoczne instancje w buforze
+void bindPlantInstances(const PlantType& type, unsigned int buffer, GLintptr offset) {
+    glBindVertexArray(type.mesh.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (int c = 0; c < 4; ++c) {
+        glEnableVertexAttribArray(3 + c);
+        glVertexAttribPointer(3 + c, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(offset + c * sizeof(glm::vec4)));
+        glVertexAttribDivisor(3 + c, 1);
     }
+}
 
-    out_vertices.clear();
-
-    for (const auto& shape : shapes) {
-        for (const auto& index : shape.mesh.indices) {
-            out_vertices.push_back(attrib.vertices[3 * index.vertex_index + 0]);
-            out_vertices.push_back(attrib.vertices[3 * index.vertex_index + 1]);
-            out_vertices.push_back(attrib.vertices[3 * index.vertex_index + 2]);
-
-            if (index.normal_index >= 0 && !attrib.normals.empty()) {
-                out_vertices.push_back(attrib.normals[3 * index.normal_index + 0]);
-                out_vertices.push_back(attrib.normals[3 * index.normal_index + 1]);
-                out_vertices.push_back(attrib.normals[3 * index.normal_index + 2]);
-            }
-            else { out_vertices.push_back(0.0f); out_vertices.push_back(1.0f); out_vertices.push_back(0.0f); }
-
-            if (index.texcoord_index >= 0 && !attrib.texcoords.empty()) {
-                out_vertices.push_back(attrib.texcoords[2 * index.texcoord_index + 0]);
-                out_vertices.push_back(1.0f - attrib.texcoords[2 * index.texcoord_index + 1]);
-            }
-            else { out_vertices.push_back(0.0f); out_vertices.push_back(0.0f); }
-        }
-    }
-    vertex_count = static_cast<int>(out_vertices.size() / 8);
-
-    if (vertex_count == 0) return false;
-
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, out_vertices.size() * sizeof(float), &out_vertices[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0); glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float))); glEnableVertexAttribArray(2);
-    glBindVertexArray(0);
+//poziom LOD (albo IMPOSTOR_BUCKET) dla sfery instancji w swiecie
+int instanceLod(const Mesh& mesh, const glm::vec3& center, float radius, const glm::vec3& eye, float lodScale, bool impostor) {
+    float distance = std::max(glm::length(center - eye), 1e-3f);
+    float screenSize = radius * lodScale / distance;
+    if (impostor && screenSize < IMPOSTOR_SCREEN_SIZE) return IMPOSTOR_BUCKET;
+    return mesh.selectLod(screenSize);
+}
 
-    std::cout << "INFO: Model loaded: " << path << ", Vertices: " << vertex_count << std::endl;
-    return true;
+//sortowanie przez zliczanie po kubelkach: kubelek l zajmuje [lodStart[l], lodStart[l + 1])
+void countLods(const int* lods, int count, int lodStart[LOD_BUCKETS + 1]) {
+    int histogram[LOD_BUCKETS] = {};
+    for (int k = 0; k < count; ++k) histogram[lods[k]]++;
+    lodStart[0] = 0;
+    for (int l = 0; l < LOD_BUCKETS; ++l) lodStart[l + 1] = lodStart[l] + histogram[l];
 }
 
-unsigned int createOceanMesh(int width, int depth, std::vector<float>& vertices, std::vector<unsigned int>& indices) {
-    vertices.clear(); indices.clear();
-    for (int z = 0; z < depth; ++z) {
-        for (int x = 0; x < width; ++x) {
-            vertices.push_back(((float)x - (float)width / 2.0f) * 2.0f);
-            vertices.push_back(0.0f);
-            vertices.push_back(((float)z - (float)depth / 2.0f) * 2.0f);
-            vertices.push_back(0.0f); vertices.push_back(1.0f); vertices.push_back(0.0f);
-        }
-    }
-    for (int z = 0; z < depth - 1; ++z) {
-        for (int x = 0; x < width - 1; ++x) {
-            int tl = (z * width) + x; int tr = tl + 1; int bl = ((z + 1) * width) + x; int br = bl + 1;
-            indices.push_back(tl); indices.push_back(bl); indices.push_back(tr);
-            indices.push_back(tr); indices.push_back(bl); indices.push_back(br);
-        }
-    }
-    unsigned int VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO); glGenBuffers(1, &VBO); glGenBuffers(1, &EBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO); glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO); glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0); glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float))); glEnableVertexAttribArray(1);
-    glBindVertexArray(0);
-    std::cout << "INFO: Ocean mesh created. Vertices: " << vertices.size() / 6 << ", Indices: " << indices.size() << std::endl;
-    return VAO;
+//ta sama transformacja co fish.vert (obrot wokol Y, skala gatunku)
+glm::mat4 fishModelMatrix(const glm::vec4& positionYaw, const FishType& type) {
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(positionYaw));
+    model = glm::rotate(model, positionYaw.w + type.yawOffset + glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return glm::scale(model, glm::vec3(type.scale));
 }
+
 unsigned int createGroundMesh(int width, int depth, std::vector<float>& vertices, std::vector<unsigned int>& indices) {
     vertices.clear();
     indices.clear();
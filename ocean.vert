@@ -5,63 +5,97 @@ layout (location = 1) in vec3 aNormal;
 out vec3 FragPos;
 out vec3 Normal;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-uniform float time;
-
-vec3 GerstnerWave(vec3 pos, float steepness, float wavelength, vec2 direction, float speed) {
-    float k = 2.0 * 3.14159 / wavelength;
-    float c = sqrt(9.8 / k) * speed;
-    vec2 d = normalize(direction);
-    float f = k * (dot(d, pos.xz) - c * time);
-    float a = steepness / k;
-
-    pos.x += d.x * a * cos(f);
-    pos.y += a * sin(f);
-    pos.z += d.y * a * cos(f);
-
-    return pos;
-}
-
-vec3 CalculateNormal(vec3 pos) {
-    float H = 0.01;
-    vec3 p_x = vec3(pos.x + H, 0.0, pos.z);
-    vec3 p_z = vec3(pos.x, 0.0, pos.z + H);
-
-    vec3 current_p = pos; //Start with original pos for normal calc base
-
-    //Apply the same waves as in main
-    current_p = GerstnerWave(current_p, 0.2, 15.0, vec2(1.0, 0.5), 1.0);
-    current_p = GerstnerWave(current_p, 0.1, 5.0, vec2(-0.3, 0.8), 1.5);
-    current_p = GerstnerWave(current_p, 0.05, 2.0, vec2(0.5, -0.5), 0.8);
-
-    p_x = GerstnerWave(p_x, 0.2, 15.0, vec2(1.0, 0.5), 1.0);
-    p_x = GerstnerWave(p_x, 0.1, 5.0, vec2(-0.3, 0.8), 1.5);
-    p_x = GerstnerWave(p_x, 0.05, 2.0, vec2(0.5, -0.5), 0.8);
-
-    p_z = GerstnerWave(p_z, 0.2, 15.0, vec2(1.0, 0.5), 1.0);
-    p_z = GerstnerWave(p_z, 0.1, 5.0, vec2(-0.3, 0.8), 1.5);
-    p_z = GerstnerWave(p_z, 0.05, 2.0, vec2(0.5, -0.5), 0.8);
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightPos;
+    vec3 lightColor;
+};
 
-    vec3 tangent = normalize(p_x - current_p);
-    vec3 bitangent = normalize(p_z - current_p);
+uniform mat4 model;
 
-    return normalize(cross(bitangent, tangent));
+// clipmapa (OceanClipmap): aPos.xz to wspolrzedne oczka na siatce poziomu
+uniform vec2 clipmapCenter;
+uniform float clipmapSpacing;
+uniform int clipmapGridHalf;
+uniform float clipmapMorphWidth;
+
+// tryb FFT: przesuniecia i normalne z OceanFFT zamiast fal Gerstnera
+uniform bool fftMode;
+uniform sampler2D fftDisplacement;
+uniform sampler2D fftNormal;
+uniform float fftPatchSize;
+uniform int fftResolution;
+
+// fale Gerstnera z GerstnerWaves (C++); MAX_WAVES = MAX_GERSTNER_WAVES
+#define MAX_WAVES 8
+struct Wave {
+    vec2 direction;     // znormalizowany na CPU
+    float steepness;
+    float wavelength;
+    float speed;
+};
+uniform Wave waves[MAX_WAVES];
+uniform int waveCount;
+
+// suma fal w jednym przebiegu: pozycja oraz analityczne pochodne
+// dP/dx (tangent) i dP/dz (binormal); fale krotsze niz ~4 oczka siatki
+// sa wygaszane, zeby dalekie poziomy clipmapy nie aliasowaly
+vec3 GerstnerWaves(vec3 pos, float spacing, out vec3 tangent, out vec3 binormal) {
+    vec3 p = pos;
+    tangent = vec3(1.0, 0.0, 0.0);
+    binormal = vec3(0.0, 0.0, 1.0);
+
+    for (int i = 0; i < waveCount; ++i) {
+        float k = 2.0 * 3.14159 / waves[i].wavelength;
+        float c = sqrt(9.8 / k) * waves[i].speed;
+        vec2 d = waves[i].direction;
+        float f = k * (dot(d, pos.xz) - c * time);
+        float q = waves[i].steepness * smoothstep(2.0 * spacing, 4.0 * spacing, waves[i].wavelength);
+        float a = q / k;
+        float s = sin(f);
+        float co = cos(f);
+
+        p.x += d.x * a * co;
+        p.y += a * s;
+        p.z += d.y * a * co;
+
+        tangent += vec3(-d.x * d.x * q * s, d.x * q * co, -d.x * d.y * q * s);
+        binormal += vec3(-d.x * d.y * q * s, d.y * q * co, -d.y * d.y * q * s);
+    }
+    return p;
 }
 
-
 void main()
 {
-    vec3 wavedPos = aPos;
-
-    wavedPos = GerstnerWave(wavedPos, 0.2, 15.0, vec2(1.0, 0.5), 1.0);
-    wavedPos = GerstnerWave(wavedPos, 0.1, 5.0, vec2(-0.3, 0.8), 1.5);
-    wavedPos = GerstnerWave(wavedPos, 0.05, 2.0, vec2(0.5, -0.5), 0.8);
+    // przy zewnetrznej krawedzi poziomu nieparzyste wierzcholki zjezdzaja na
+    // siatke poziomu wyzej (morph = 1 na samej krawedzi) - szwy bez T-polaczen
+    vec2 grid = aPos.xz;
+    float edgeDistance = max(abs(grid.x), abs(grid.y));
+    float morph = clamp((edgeDistance - (float(clipmapGridHalf) - clipmapMorphWidth)) / clipmapMorphWidth, 0.0, 1.0);
+    grid -= (grid - 2.0 * floor(grid * 0.5)) * morph;
+    vec2 worldXZ = clipmapCenter + grid * clipmapSpacing;
+    vec3 basePos = vec3(worldXZ.x, 0.0, worldXZ.y);
+    float spacing = clipmapSpacing * (1.0 + morph);
+
+    if (fftMode) {
+        // srodek tekselu (n, m) odpowiada punktowi (n, m) * L / N
+        vec2 uv = basePos.xz / fftPatchSize + 0.5 / float(fftResolution);
+        vec3 displaced = basePos + textureLod(fftDisplacement, uv, 0.0).xyz;
+        FragPos = vec3(model * vec4(displaced, 1.0));
+        Normal = mat3(transpose(inverse(model))) * textureLod(fftNormal, uv, 0.0).xyz;
+        gl_Position = projection * view * vec4(FragPos, 1.0);
+        return;
+    }
+
+    vec3 tangent, binormal;
+    vec3 wavedPos = GerstnerWaves(basePos, spacing, tangent, binormal);
 
     FragPos = vec3(model * vec4(wavedPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * CalculateNormal(aPos);
+    Normal = mat3(transpose(inverse(model))) * normalize(cross(binormal, tangent));
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
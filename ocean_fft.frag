@@ -0,0 +1,48 @@
+#version 330 core
+// jeden etap odwrotnej FFT (Stockham radix-2) wzdluz x albo z;
+// ta sama formula co OceanFFT::inverseFFT na CPU
+layout (location = 0) out vec4 out0;
+layout (location = 1) out vec4 out1;
+layout (location = 2) out vec4 out2;
+
+uniform sampler2D input0;
+uniform sampler2D input1;
+uniform sampler2D input2;
+uniform int resolution;
+uniform int stage;      // Ns = 1, 2, 4, ..., N/2
+uniform int vertical;
+
+const float PI = 3.14159265358979;
+
+vec2 cmul(vec2 a, vec2 b)
+{
+    return vec2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+}
+
+// rgba = dwie liczby zespolone przetwarzane razem
+vec4 butterfly(vec4 a, vec4 b, vec2 w, float s)
+{
+    return vec4(a.xy + s * cmul(w, b.xy), a.zw + s * cmul(w, b.zw));
+}
+
+void main()
+{
+    ivec2 id = ivec2(gl_FragCoord.xy);
+    int i = vertical == 1 ? id.y : id.x;
+
+    int k = i % (2 * stage);
+    int r = k >= stage ? 1 : 0;
+    int jm = k - r * stage;
+    int j = (i / (2 * stage)) * stage + jm;
+
+    float angle = 2.0 * PI * float(jm) / float(2 * stage);
+    vec2 w = vec2(cos(angle), sin(angle));
+    float s = r == 1 ? -1.0 : 1.0;
+
+    ivec2 ia = vertical == 1 ? ivec2(id.x, j) : ivec2(j, id.y);
+    ivec2 ib = vertical == 1 ? ivec2(id.x, j + resolution / 2) : ivec2(j + resolution / 2, id.y);
+
+    out0 = butterfly(texelFetch(input0, ia, 0), texelFetch(input0, ib, 0), w, s);
+    out1 = butterfly(texelFetch(input1, ia, 0), texelFetch(input1, ib, 0), w, s);
+    out2 = butterfly(texelFetch(input2, ia, 0), texelFetch(input2, ib, 0), w, s);
+}
@@ -0,0 +1,29 @@
+#version 330 core
+// wynik FFT -> przesuniecia (dx, h, dz) i normalne oceanu
+layout (location = 0) out vec4 displacement;
+layout (location = 1) out vec4 normal;
+
+uniform sampler2D input0;   // h, Dx
+uniform sampler2D input1;   // Dz, nachylenie x
+uniform sampler2D input2;   // nachylenie z
+uniform float choppiness;
+
+void main()
+{
+    ivec2 id = ivec2(gl_FragCoord.xy);
+    // indeksy k przesuniete o N/2 -> czynnik (-1)^(x+z)
+    float sign = ((id.x + id.y) & 1) == 1 ? -1.0 : 1.0;
+
+    vec4 a = texelFetch(input0, id, 0);
+    vec4 b = texelFetch(input1, id, 0);
+    vec4 c = texelFetch(input2, id, 0);
+
+    float h = a.x * sign;
+    float dx = a.z * sign * choppiness;
+    float dz = b.x * sign * choppiness;
+    float sx = b.z * sign;
+    float sz = c.x * sign;
+
+    displacement = vec4(dx, h, dz, 0.0);
+    normal = vec4(normalize(vec3(-sx, 1.0, -sz)), 0.0);
+}
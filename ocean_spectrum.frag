@@ -0,0 +1,41 @@
+#version 330 core
+// h(k, t) = h0(k) e^{iwt} + conj(h0(-k)) e^{-iwt} oraz pochodne widmowe
+layout (location = 0) out vec4 out0; // h, Dx
+layout (location = 1) out vec4 out1; // Dz, nachylenie x
+layout (location = 2) out vec4 out2; // nachylenie z
+
+uniform sampler2D h0Texture;        // rg = h0(k), ba = conj(h0(-k))
+uniform int resolution;
+uniform float patchSize;
+uniform float spectrumTime;
+
+const float PI = 3.14159265358979;
+const float GRAVITY = 9.81;
+
+vec2 cmul(vec2 a, vec2 b)
+{
+    return vec2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+}
+
+void main()
+{
+    ivec2 id = ivec2(gl_FragCoord.xy);
+    vec2 k = 2.0 * PI * vec2(id - ivec2(resolution / 2)) / patchSize;
+    float len = length(k);
+    float w = sqrt(GRAVITY * len) * spectrumTime;
+    vec2 e = vec2(cos(w), sin(w));
+
+    vec4 h0 = texelFetch(h0Texture, id, 0);
+    vec2 h = cmul(h0.xy, e) + cmul(h0.zw, vec2(e.x, -e.y));
+
+    vec2 kn = len > 1e-6 ? k / len : vec2(0.0);
+    // -i*kn*h (przesuniecia poziome) oraz i*k*h (nachylenia)
+    vec2 dx = vec2(kn.x * h.y, -kn.x * h.x);
+    vec2 dz = vec2(kn.y * h.y, -kn.y * h.x);
+    vec2 sx = vec2(-k.x * h.y, k.x * h.x);
+    vec2 sz = vec2(-k.y * h.y, k.y * h.x);
+
+    out0 = vec4(h, dx);
+    out1 = vec4(dz, sx);
+    out2 = vec4(sz, 0.0, 0.0);
+}
@@ -1,23 +1,30 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
+layout (location = 3) in mat4 aInstanceModel; // lokacje 3..6, divisor 1
 
 out vec3 FragPos;
 out vec3 Normal;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightPos;
+    vec3 lightColor;
+};
 
 void main()
 {
-    // pozycja w przestrzeni ?wiata
-    vec4 worldPos = model * vec4(aPos, 1.0);
+    // pozycja w przestrzeni swiata
+    vec4 worldPos = aInstanceModel * vec4(aPos, 1.0);
     FragPos       = worldPos.xyz;
 
-    // normalne w przestrzeni ?wiata (prawid?owe dla skalowanych modeli)
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    // skala instancji jest jednorodna, wiec mat3(model) wystarcza (normalizacja w plant.frag)
+    Normal = mat3(aInstanceModel) * aNormal;
 
-    // ko?cowa pozycja w clip-space
+    // koncowa pozycja w clip-space
     gl_Position = projection * view * worldPos;
 }
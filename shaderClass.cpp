@@ -44,6 +44,32 @@ Shader::Shader(const char* vertexFile, const char* fragmentFile)
 
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
+
+    reflectUniforms();
+}
+
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+
+Shader::Shader(const char* computeFile)
+{
+    std::string computeCode = get_file_contents(computeFile);
+    const char* computeSource = computeCode.c_str();
+
+    GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(computeShader, 1, &computeSource, NULL);
+    glCompileShader(computeShader);
+    compileErrors(computeShader, "COMPUTE");
+
+    ID = glCreateProgram();
+    glAttachShader(ID, computeShader);
+    glLinkProgram(ID);
+    compileErrors(ID, "PROGRAM");
+
+    glDeleteShader(computeShader);
+
+    reflectUniforms();
 }
 
 void Shader::Activate()
@@ -80,33 +106,120 @@ void Shader::compileErrors(unsigned int shader, const char* type)
     }
 }
 
+// Wszystkie aktywne uniformy programu trafiaja do tablicy lokacji zaraz po
+// linkowaniu, wiec set*() nie odpytuje juz sterownika w kazdej klatce.
+void Shader::reflectUniforms()
+{
+    uniformLocations.clear();
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    if (count <= 0 || maxLength <= 0) return;
+
+    std::string name(maxLength, '\0');
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, (GLuint)i, maxLength, &length, &size, &type, &name[0]);
+        std::string uniformName = name.substr(0, length);
+
+        // uniformy z blokow (UBO) nie maja lokacji
+        GLint location = glGetUniformLocation(ID, uniformName.c_str());
+        if (location < 0) continue;
+        uniformLocations[uniformName] = location;
+
+        // tablice: "waves[0]" -> "waves" oraz kazdy element "waves[i]"
+        size_t bracket = uniformName.find('[');
+        if (bracket != std::string::npos)
+        {
+            std::string base = uniformName.substr(0, bracket);
+            std::string member = uniformName.substr(uniformName.find(']') + 1);
+            if (member.empty()) uniformLocations[base] = location;
+            for (GLint e = 1; e < size; ++e)
+            {
+                std::string elementName = base + "[" + std::to_string(e) + "]" + member;
+                GLint elementLocation = glGetUniformLocation(ID, elementName.c_str());
+                if (elementLocation >= 0) uniformLocations[elementName] = elementLocation;
+            }
+        }
+    }
+}
+
+UniformHandle Shader::uniform(const std::string& name) const
+{
+    UniformHandle handle;
+    auto it = uniformLocations.find(name);
+    if (it != uniformLocations.end()) handle.location = it->second;
+    return handle;
+}
+
+void Shader::bindUniformBlock(const char* blockName, GLuint binding) const
+{
+    GLuint index = glGetUniformBlockIndex(ID, blockName);
+    if (index != GL_INVALID_INDEX)
+        glUniformBlockBinding(ID, index, binding);
+}
+
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    setMat4(uniform(name), mat);
 }
 
 
 void Shader::setVec3(const std::string& name, const glm::vec3& value) const
 {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+    setVec3(uniform(name), value);
 }
 
 void Shader::setFloat(const std::string& name, float value) const
 {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    setFloat(uniform(name), value);
 }
 
 void Shader::setInt(const std::string& name, int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    setInt(uniform(name), value);
 }
 
 void Shader::setBool(const std::string& name, bool value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    setBool(uniform(name), value);
 }
 void Shader::use() {
     glUseProgram(ID);
 }
 void Shader::setVec2(const std::string& name, const glm::vec2& value) const {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    setVec2(uniform(name), value);
+}
+
+void Shader::setMat4(UniformHandle handle, const glm::mat4& mat) const
+{
+    glUniformMatrix4fv(handle.location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setVec3(UniformHandle handle, const glm::vec3& value) const
+{
+    glUniform3fv(handle.location, 1, glm::value_ptr(value));
+}
+
+void Shader::setFloat(UniformHandle handle, float value) const
+{
+    glUniform1f(handle.location, value);
+}
+
+void Shader::setInt(UniformHandle handle, int value) const
+{
+    glUniform1i(handle.location, value);
+}
+
+void Shader::setBool(UniformHandle handle, bool value) const
+{
+    glUniform1i(handle.location, (int)value);
+}
+
+void Shader::setVec2(UniformHandle handle, const glm::vec2& value) const
+{
+    glUniform2fv(handle.location, 1, &value[0]);
 }
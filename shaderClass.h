@@ -8,17 +8,27 @@
 #include <sstream>
 #include <iostream>
 #include <cerrno>
+#include <unordered_map>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 std::string get_file_contents(const char* filename);
 
+// Lokacja uniformu pobrana raz, do uzycia w goracych petlach bez stringow.
+struct UniformHandle
+{
+    GLint location = -1;
+    bool valid() const { return location >= 0; }
+};
+
 class Shader
 {
 public:
     GLuint ID;
     Shader(const char* vertexFile, const char* fragmentFile);
+    // program z jednym compute shaderem (wymaga kontekstu GL 4.3)
+    explicit Shader(const char* computeFile);
 
     void Activate();
     void Delete();
@@ -32,9 +42,22 @@ public:
     void setMat4(const std::string& name, const glm::mat4& mat) const;
     void setVec2(const std::string& name, const glm::vec2& value) const;
 
+    UniformHandle uniform(const std::string& name) const;
+    void bindUniformBlock(const char* blockName, GLuint binding) const;
+
+    void setBool(UniformHandle handle, bool value) const;
+    void setInt(UniformHandle handle, int value) const;
+    void setFloat(UniformHandle handle, float value) const;
+    void setVec3(UniformHandle handle, const glm::vec3& value) const;
+    void setMat4(UniformHandle handle, const glm::mat4& mat) const;
+    void setVec2(UniformHandle handle, const glm::vec2& value) const;
+
 
 private:
+    std::unordered_map<std::string, GLint> uniformLocations;
+
     void compileErrors(unsigned int shader, const char* type);
+    void reflectUniforms();
 };
 
 